@@ -0,0 +1,78 @@
+#ifndef KMK_BLIT_H
+#define KMK_BLIT_H
+
+#include <cstdint>
+#include <cstring>
+
+#include "progmem.h"
+#include "ssd1306_buffer.h"
+
+namespace kmk
+{
+namespace ssd1306
+{
+    enum class BlitMode : uint8_t {
+        Copy,  // Replace the covered pixels, also the black ones.
+        Or,    // Only set pixels, like Adafruit_GFX::drawBitmap with a transparent background.
+        Xor,   // Toggle pixels, handy for erasing a sprite by drawing it again.
+    };
+
+    /**
+     * Copies a page-major (PROGMEM) image of w x h pixels into a page-major framebuffer at (x, y).
+     *
+     * When y is a multiple of 8 the image bytes line up with the framebuffer pages, and in Copy mode
+     * every full page of a row that is not clipped is one memcpy. Otherwise each source byte is split
+     * across two pages with shifts and masks. Pixels outside the framebuffer are clipped.
+    */
+    inline void blitPageMajor(uint8_t* buffer, int16_t bufferWidth, int16_t bufferHeight,
+                              int16_t x, int16_t y, const uint8_t* image, int16_t w, int16_t h,
+                              BlitMode mode = BlitMode::Copy) {
+        if (w <= 0 || h <= 0 || x >= bufferWidth || y >= bufferHeight || x + w <= 0 || y + h <= 0) {
+            return;
+        }
+
+        const int16_t bufferPages = (bufferHeight + 7) / 8;
+        const int16_t imagePages = (h + 7) / 8;
+        const int16_t x0 = x < 0 ? 0 : x;
+        const int16_t x1 = x + w > bufferWidth ? bufferWidth : x + w;
+        const int16_t pageY = y >= 0 ? y / 8 : -((7 - y) / 8);  // Floor division for sprites partly above the screen.
+        const uint8_t shift = static_cast<uint8_t>(y - pageY * 8);
+
+        for (int16_t sp = 0; sp < imagePages; ++sp) {
+            const int16_t rows = h - sp * 8;
+            const uint8_t rowMask = rows >= 8 ? 0xFF : static_cast<uint8_t>((1u << rows) - 1u);
+            const uint8_t* src = image + sp * w + (x0 - x);
+            const int16_t dp = pageY + sp;
+
+            if (shift == 0 && rowMask == 0xFF && mode == BlitMode::Copy) {
+                if (dp >= 0 && dp < bufferPages) {
+                    // Teensy keeps PROGMEM in the normal address space, so memcpy reads it directly.
+                    std::memcpy(buffer + dp * bufferWidth + x0, src, x1 - x0);
+                }
+                continue;
+            }
+
+            const uint16_t wideMask = static_cast<uint16_t>(rowMask) << shift;
+            for (int16_t column = x0; column < x1; ++column) {
+                const uint16_t bits = static_cast<uint16_t>(pgm_read_byte(src + (column - x0)) & rowMask) << shift;
+                for (int16_t half = 0; half < 2; ++half) {
+                    const int16_t page = dp + half;
+                    const uint8_t mask = static_cast<uint8_t>(wideMask >> (8 * half));
+                    if (mask == 0 || page < 0 || page >= bufferPages) {
+                        continue;
+                    }
+                    const uint8_t value = static_cast<uint8_t>(bits >> (8 * half));
+                    uint8_t& target = buffer[page * bufferWidth + column];
+                    switch (mode) {
+                        case BlitMode::Copy: target = static_cast<uint8_t>((target & ~mask) | value); break;
+                        case BlitMode::Or: target |= value; break;
+                        case BlitMode::Xor: target ^= value; break;
+                    }
+                }
+            }
+        }
+    }
+}
+}
+
+#endif // KMK_BLIT_H
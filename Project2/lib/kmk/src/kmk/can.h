@@ -0,0 +1,24 @@
+#ifndef KMK_CAN_H
+#define KMK_CAN_H
+
+#include <cstdint>
+
+namespace kmk
+{
+namespace can
+{
+    /**
+     * A received frame as the rest of the code sees it, copied out of the driver's message type
+     * (FlexCAN_T4's CAN_message_t on the Teensy) in the receive interrupt.
+    */
+    struct Frame {
+        uint32_t micros;  // Arrival time.
+        uint32_t id;
+        uint8_t length;
+        bool extended;
+        uint8_t data[8];
+    };
+}
+}
+
+#endif // KMK_CAN_H
@@ -0,0 +1,225 @@
+#ifndef KMK_CAN_SCHEMA_H
+#define KMK_CAN_SCHEMA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+namespace kmk
+{
+namespace can
+{
+    /**
+     * Byte order of a field, by the names DBC files use: Intel is little endian, Motorola big endian.
+    */
+    enum class ByteOrder : uint8_t {
+        Intel,
+        Motorola,
+    };
+
+    template<typename T>
+    struct MemberOf;
+
+    template<typename Owner, typename T>
+    struct MemberOf<T Owner::*> {
+        using owner = Owner;
+        using type = T;
+    };
+
+    /**
+     * One field of a message: the struct member Member, Bits wide, at bit Start of the data bytes.
+     *   Intel:    Start is the field's least significant bit, counted from bit 0 of byte 0 upwards (as in DBC).
+     *   Motorola: Start is the field's most significant bit, counted from bit 7 of byte 0 through the bytes
+     *             in order, so a 16 bit field in bytes 2 and 3 starts at 16.
+     * Integers (signed ones sign-extended), bools and enums, at most 32 bits. name and unit are only for the
+     * DBC export; encoding uses nothing but the template arguments.
+    */
+    template<auto Member, uint8_t Start, uint8_t Bits, ByteOrder Order = ByteOrder::Intel>
+    struct Field {
+        using Owner = typename MemberOf<decltype(Member)>::owner;
+        using Type = typename MemberOf<decltype(Member)>::type;
+        using Raw = typename std::conditional<std::is_enum<Type>::value, std::underlying_type<Type>,
+                                              std::common_type<Type>>::type::type;
+        static_assert(std::is_integral<Raw>::value, "Fields are integers, bools or enums");
+        static_assert(Bits >= 1 && Bits <= 32 && Bits <= 8 * sizeof(Raw), "A field holds 1 to 32 bits of its member");
+        static_assert(Start + Bits <= 64, "A field ends past the 8 data bytes");
+
+        static constexpr uint8_t start = Start;
+        static constexpr uint8_t bits = Bits;
+        static constexpr ByteOrder order = Order;
+        static constexpr bool isSigned = std::is_signed<Raw>::value;
+
+        const char* name;
+        const char* unit = "";
+
+        /**
+         * The data bytes seen as one 64 bit number, byte 0 lowest for Intel and highest for Motorola: the
+         * field's least significant bit, the shift of byte i and the field bits byte i holds.
+        */
+        static constexpr int lsb = Order == ByteOrder::Intel ? Start : 64 - Start - Bits;
+        static constexpr int byteShift(int i) { return Order == ByteOrder::Intel ? 8 * i : 56 - 8 * i; }
+        static constexpr uint8_t byteMask(int i) {
+            return static_cast<uint8_t>((((uint64_t{1} << Bits) - 1) << lsb) >> byteShift(i));
+        }
+
+        template<typename Message>
+        static void encode(const Message& message, uint8_t* data) {
+            const uint32_t raw = static_cast<uint32_t>(static_cast<Raw>(message.*Member));
+            put(data, raw, std::make_index_sequence<8>{});
+        }
+
+        template<typename Message>
+        static void decode(const uint8_t* data, Message& message) {
+            uint32_t raw = get(data, std::make_index_sequence<8>{});
+            if constexpr (isSigned && Bits < 32) {
+                raw = static_cast<uint32_t>(static_cast<int32_t>(raw << (32 - Bits)) >> (32 - Bits));
+            }
+            if constexpr (std::is_same<Raw, bool>::value) {
+                message.*Member = raw != 0;
+            } else {
+                message.*Member = static_cast<Type>(static_cast<Raw>(raw));
+            }
+        }
+
+    private:
+        // Byte by byte with every shift and mask known at compile time: whole bytes are plain stores and loads,
+        // only bytes shared with another field are read, masked and written back.
+        template<int I>
+        static void putByte(uint8_t* data, uint32_t raw) {
+            constexpr uint8_t mask = byteMask(I);
+            constexpr int shift = byteShift(I) - lsb;
+            if constexpr (mask != 0) {
+                uint32_t part;
+                if constexpr (shift >= 0) {
+                    part = raw >> shift;
+                } else {
+                    part = raw << -shift;
+                }
+                if constexpr (mask == 0xFF) {
+                    data[I] = static_cast<uint8_t>(part);
+                } else {
+                    data[I] = static_cast<uint8_t>((data[I] & ~mask) | (part & mask));
+                }
+            }
+        }
+
+        template<int I>
+        static uint32_t getByte(const uint8_t* data) {
+            constexpr uint8_t mask = byteMask(I);
+            constexpr int shift = byteShift(I) - lsb;
+            if constexpr (mask == 0) {
+                return 0;
+            } else {
+                const uint32_t part = mask == 0xFF ? data[I] : data[I] & mask;
+                if constexpr (shift >= 0) {
+                    return part << shift;
+                } else {
+                    return part >> -shift;
+                }
+            }
+        }
+
+        template<std::size_t... I>
+        static void put(uint8_t* data, uint32_t raw, std::index_sequence<I...>) {
+            (putByte<I>(data, raw), ...);
+        }
+
+        template<std::size_t... I>
+        static uint32_t get(const uint8_t* data, std::index_sequence<I...>) {
+            return (getByte<I>(data) | ...);
+        }
+    };
+
+    template<typename... Fields>
+    constexpr bool disjoint() {
+        for (int i = 0; i < 8; ++i) {
+            uint8_t used = 0;
+            for (const uint8_t mask : {uint8_t{0}, Fields::byteMask(i)...}) {
+                if ((used & mask) != 0) {
+                    return false;
+                }
+                used = static_cast<uint8_t>(used | mask);
+            }
+        }
+        return true;
+    }
+
+    /**
+     * The fields of a message with Length data bytes, checked at compile time to fit in them and not to
+     * overlap. A message is a plain struct with a static constexpr layout member:
+     *
+     *     struct Coordinates {
+     *         int16_t x;
+     *         int16_t y;
+     *         static constexpr auto layout = can::layout<4>("Coordinates",
+     *             can::Field<&Coordinates::x, 0, 16>{"X"}, can::Field<&Coordinates::y, 16, 16>{"Y"});
+     *     };
+    */
+    template<uint8_t Length, typename... Fields>
+    struct Layout {
+        static_assert(Length <= 8, "A CAN frame carries at most 8 data bytes");
+        // Start counts through the bytes in order for both byte orders, so this is where any field ends.
+        static_assert(((Fields::start + Fields::bits <= 8 * Length) && ...), "A field ends past the message's length");
+
+        static constexpr uint8_t length = Length;
+
+        const char* name;
+        std::tuple<Fields...> fields;
+
+        static_assert(disjoint<Fields...>(), "Two fields share bits");
+
+        // Written by one field in full; the others are cleared first, so unused bits go out as zeros.
+        static constexpr bool owned(int i) { return (false || ... || (Fields::byteMask(i) == 0xFF)); }
+
+        template<typename Message>
+        static void encode(const Message& message, uint8_t* data) {
+            clear(data, std::make_index_sequence<Length>{});
+            (Fields::encode(message, data), ...);
+        }
+
+        template<typename Message>
+        static void decode(const uint8_t* data, Message& message) {
+            (Fields::decode(data, message), ...);
+        }
+
+    private:
+        template<std::size_t... I>
+        static void clear(uint8_t* data, std::index_sequence<I...>) {
+            ((owned(I) ? void() : void(data[I] = 0)), ...);
+        }
+    };
+
+    template<uint8_t Length, typename... Fields>
+    constexpr Layout<Length, Fields...> layout(const char* name, Fields... fields) {
+        return {name, std::tuple<Fields...>(fields...)};
+    }
+
+    template<typename Message>
+    using LayoutOf = typename std::decay<decltype(Message::layout)>::type;
+
+    /**
+     * Writes message into data (at least its length bytes) and returns the length, for CAN_message_t::len.
+    */
+    template<typename Message>
+    uint8_t encode(const Message& message, uint8_t* data) {
+        LayoutOf<Message>::encode(message, data);
+        return LayoutOf<Message>::length;
+    }
+
+    /**
+     * Reads message from a frame's data. Returns false, leaving message alone, if the frame is too short.
+    */
+    template<typename Message>
+    bool decode(const uint8_t* data, uint8_t length, Message& message) {
+        if (length < LayoutOf<Message>::length) {
+            return false;
+        }
+        LayoutOf<Message>::decode(data, message);
+        return true;
+    }
+}
+}
+
+#endif // KMK_CAN_SCHEMA_H
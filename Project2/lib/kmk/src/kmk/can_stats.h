@@ -0,0 +1,217 @@
+#ifndef KMK_CAN_STATS_H
+#define KMK_CAN_STATS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "can.h"
+
+namespace kmk
+{
+namespace can
+{
+    /**
+     * Bits a data frame occupies on the bus, SOF to the end of the intermission, without stuff bits. Stuffing adds
+     * up to about 20 %, so loads computed from this are a lower bound.
+    */
+    constexpr uint32_t frameBits(uint8_t length, bool extended) {
+        return (extended ? 67u : 47u) + 8u * length;
+    }
+
+    /**
+     * What is known about one CAN ID. Gaps are inter-arrival times in microseconds.
+    */
+    struct IdStats {
+        uint32_t id{0};
+        bool extended{false};
+        uint32_t count{0};
+        uint8_t length{0};
+        uint8_t data[8]{};
+        uint32_t lastMicros{0};
+        uint32_t minGap{~uint32_t{0}};
+        uint32_t maxGap{0};
+        uint64_t gapTotal{0};
+        float rate{0.0f};  // Frames per second, smoothed over the last ~8 frames.
+
+        uint32_t meanGap() const { return count > 1 ? static_cast<uint32_t>(gapTotal / (count - 1)) : 0; }
+
+        /**
+         * rate, but falling once the ID has been silent for longer than its gap: an ID that stops does not keep
+         * its last rate forever.
+        */
+        float rateAt(uint32_t now) const {
+            const uint32_t silent = now - lastMicros;
+            if (count == 0 || silent == 0) {
+                return rate;
+            }
+            const float bound = 1e6f / static_cast<float>(silent);
+            return bound < rate ? bound : rate;
+        }
+    };
+
+    /**
+     * Per-ID statistics in a fixed open-addressing table (linear probing, Fibonacci hashing), so record() is a
+     * hash, usually one compare and a few additions, with nothing allocated. Capacity is a power of two and at
+     * most three quarters of it is filled to keep probe runs short; frames of further IDs are only counted in
+     * untracked(). Also measures the bus load from the frame lengths, over whole seconds.
+     *
+     * Times are micros() values and compared by subtraction, so the wrap-around every 71 minutes is harmless.
+    */
+    template<std::size_t Capacity>
+    class Statistics {
+        static_assert(Capacity >= 4 && (Capacity & (Capacity - 1)) == 0, "Statistics capacity must be a power of two");
+
+    public:
+        static constexpr std::size_t maxIds = Capacity * 3 / 4;
+
+        explicit Statistics(uint32_t bitrate) : bitrate_(bitrate) {}
+
+        /**
+         * Counts frame. Returns its ID's statistics, or nullptr when the table is full.
+        */
+        const IdStats* record(const Frame& frame) {
+            update(frame.micros);
+            windowBits_ += frameBits(frame.length, frame.extended);
+            ++total_;
+
+            const uint32_t key = keyOf(frame.id, frame.extended);
+            std::size_t i = slot(key);
+            while (used_[i] && keys_[i] != key) {
+                i = (i + 1) & mask;
+            }
+            IdStats& stats = entries_[i];
+            if (!used_[i]) {
+                if (size_ == maxIds) {
+                    ++untracked_;
+                    return nullptr;
+                }
+                used_[i] = true;
+                keys_[i] = key;
+                ++size_;
+                stats = IdStats{};
+                stats.id = frame.id;
+                stats.extended = frame.extended;
+            } else {
+                const uint32_t gap = frame.micros - stats.lastMicros;
+                stats.minGap = gap < stats.minGap ? gap : stats.minGap;
+                stats.maxGap = gap > stats.maxGap ? gap : stats.maxGap;
+                stats.gapTotal += gap;
+                if (gap > 0) {
+                    const float instant = 1e6f / static_cast<float>(gap);
+                    stats.rate = stats.count == 1 ? instant : stats.rate + (instant - stats.rate) / 8.0f;
+                }
+            }
+            ++stats.count;
+            stats.lastMicros = frame.micros;
+            stats.length = frame.length;
+            std::memcpy(stats.data, frame.data, sizeof(stats.data));
+            return &stats;
+        }
+
+        const IdStats* find(uint32_t id, bool extended = false) const {
+            const uint32_t key = keyOf(id, extended);
+            for (std::size_t i = slot(key); used_[i]; i = (i + 1) & mask) {
+                if (keys_[i] == key) {
+                    return &entries_[i];
+                }
+            }
+            return nullptr;
+        }
+
+        /**
+         * Closes the load measurement window once a second has passed. record() does it too, call it from loop()
+         * so the load also drops when the bus goes quiet. A frame stamped before the window started (received
+         * before that call, recorded after it) counts in the current window and does not close it.
+        */
+        void update(uint32_t now) {
+            if (static_cast<int32_t>(now - windowStart_) < 0) {
+                return;
+            }
+            const uint32_t elapsed = now - windowStart_;
+            if (elapsed >= 1000000) {
+                load_ = static_cast<float>(windowBits_) / (static_cast<float>(bitrate_) * (elapsed / 1e6f));
+                windowBits_ = 0;
+                windowStart_ = now;
+            }
+        }
+
+        /**
+         * Fills out with the IDs with the highest rate at now, busiest first. Returns how many there were,
+         * at most N. A pass over the table per entry, fine for the few rows a screen has room for.
+        */
+        template<std::size_t N>
+        std::size_t top(const IdStats* (&out)[N], uint32_t now) const {
+            std::size_t found = 0;
+            float rates[N]{};
+            for (std::size_t i = 0; i < Capacity; ++i) {
+                if (!used_[i]) {
+                    continue;
+                }
+                const float rate = entries_[i].rateAt(now);
+                std::size_t at = found < N ? found++ : N;
+                for (; at > 0 && rates[at - 1] < rate; --at) {
+                    if (at < N) {
+                        out[at] = out[at - 1];
+                        rates[at] = rates[at - 1];
+                    }
+                }
+                if (at < N) {
+                    out[at] = &entries_[i];
+                    rates[at] = rate;
+                }
+            }
+            return found;
+        }
+
+        // Calls visit(stats) for every ID, in table order.
+        template<typename Visit>
+        void forEach(Visit&& visit) const {
+            for (std::size_t i = 0; i < Capacity; ++i) {
+                if (used_[i]) {
+                    visit(static_cast<const IdStats&>(entries_[i]));
+                }
+            }
+        }
+
+        uint32_t total() const { return total_; }
+        uint32_t untracked() const { return untracked_; }
+        std::size_t size() const { return size_; }
+        // Share of the bit rate used during the last whole second, 0 to 1.
+        float busLoad() const { return load_; }
+
+    private:
+        static constexpr std::size_t mask = Capacity - 1;
+
+        static constexpr uint8_t log2(std::size_t value) {
+            uint8_t bits = 0;
+            for (; value > 1; value >>= 1) {
+                ++bits;
+            }
+            return bits;
+        }
+
+        // 29 bit IDs, so bit 31 is free to tell an extended ID from a standard one with the same number.
+        static constexpr uint32_t keyOf(uint32_t id, bool extended) { return id | (extended ? 0x80000000u : 0u); }
+
+        // Fibonacci hashing: the top bits of key * 2^32 / phi, which spreads runs of consecutive IDs.
+        static constexpr std::size_t slot(uint32_t key) {
+            return static_cast<std::size_t>((key * 2654435769u) >> (32 - log2(Capacity)));
+        }
+
+        IdStats entries_[Capacity]{};
+        uint32_t keys_[Capacity]{};
+        bool used_[Capacity]{};
+        std::size_t size_{0};
+        uint32_t total_{0};
+        uint32_t untracked_{0};
+
+        uint32_t bitrate_;
+        uint32_t windowStart_{0};
+        uint32_t windowBits_{0};
+        float load_{0.0f};
+    };
+}
+}
+
+#endif // KMK_CAN_STATS_H
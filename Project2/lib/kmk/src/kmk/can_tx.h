@@ -0,0 +1,195 @@
+#ifndef KMK_CAN_TX_H
+#define KMK_CAN_TX_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "can.h"
+#include "can_schema.h"
+
+namespace kmk
+{
+namespace can
+{
+    /**
+     * How one class of messages is sent. Times are in microseconds.
+    */
+    struct TxClass {
+        uint8_t priority;         // Lower goes first when several classes are due.
+        uint32_t periodMicros;    // 0: sent once per queue(). Else sent every period with the latest data.
+        uint32_t deadlineMicros;  // 0: none. Else dropped when not out this long after it was due.
+    };
+
+    struct TxCounters {
+        uint32_t sent{0};
+        uint32_t coalesced{0};  // Replaced by a newer frame before it went out.
+        uint32_t dropped{0};    // Past the deadline.
+        uint32_t late{0};       // Went out, but not in the first pump() after it was due.
+        uint32_t maxDelay{0};   // Longest time from due to out.
+    };
+
+    /**
+     * Transmit scheduler in front of the driver's mailboxes. Each message class holds at most one frame, so a
+     * newer frame replaces an unsent older one instead of queueing behind it, and pump() hands the driver the
+     * due frames in priority order, stopping as soon as it refuses one. A full driver queue therefore delays
+     * the least important frames, never loses the state frame behind chatter, and what waits too long is dropped
+     * rather than sent stale. Periodic classes also go out at once when their data changes.
+     *
+     * Times are micros() values, compared by subtraction, so the wrap-around does not matter.
+    */
+    template<std::size_t Classes>
+    class TxScheduler {
+    public:
+        explicit TxScheduler(const std::array<TxClass, Classes>& classes) : classes_(classes) {}
+
+        /**
+         * Sets the frame of a class. Replaces one that has not gone out yet.
+        */
+        void queue(std::size_t index, const Frame& frame, uint32_t now) {
+            Slot& slot = slots_[index];
+            const bool periodic = classes_[index].periodMicros > 0;
+            if (periodic) {
+                // Starting, or new data: due now. Otherwise the period keeps its rhythm.
+                if (!slot.active || !sameData(slot.frame, frame)) {
+                    slot.due = now;
+                    slot.pending = true;
+                    slot.tried = false;
+                }
+            } else {
+                if (slot.active) {
+                    ++counters_[index].coalesced;
+                }
+                slot.due = now;
+                slot.pending = true;
+                slot.tried = false;
+            }
+            slot.frame = frame;
+            slot.active = true;
+        }
+
+        template<typename Message>
+        void queue(std::size_t index, uint32_t id, const Message& message, uint32_t now) {
+            Frame frame{now, id, 0, false, {}};
+            frame.length = encode(message, frame.data);
+            queue(index, frame, now);
+        }
+
+        // Stops a periodic class, or withdraws a frame not sent yet.
+        void cancel(std::size_t index) { slots_[index].active = false; }
+
+        /**
+         * Sends the due frames, most important first, until Bus::write(const Frame&) returns false or maxFrames
+         * have gone. Returns how many went out.
+        */
+        template<typename Bus>
+        std::size_t pump(uint32_t now, Bus& bus, std::size_t maxFrames = Classes) {
+            std::size_t sent = 0;
+            while (sent < maxFrames) {
+                const std::size_t index = nextDue(now);
+                if (index == Classes) {
+                    break;
+                }
+                Slot& slot = slots_[index];
+                TxCounters& counters = counters_[index];
+                const uint32_t delay = now - slot.due;
+                if (classes_[index].deadlineMicros > 0 && delay > classes_[index].deadlineMicros) {
+                    ++counters.dropped;
+                    done(index, now);
+                    continue;
+                }
+                if (!bus.write(slot.frame)) {
+                    slot.tried = true;
+                    break;
+                }
+                ++counters.sent;
+                counters.late += slot.tried;
+                counters.maxDelay = delay > counters.maxDelay ? delay : counters.maxDelay;
+                done(index, now);
+                ++sent;
+            }
+            // Whatever is still due now has missed this pump.
+            for (std::size_t i = 0; i < Classes; ++i) {
+                slots_[i].tried = slots_[i].tried || isDue(i, now);
+            }
+            return sent;
+        }
+
+        const TxCounters& counters(std::size_t index) const { return counters_[index]; }
+
+    private:
+        struct Slot {
+            Frame frame{};
+            uint32_t due{0};
+            bool active{false};
+            bool pending{false};  // Not sent since it was due.
+            bool tried{false};    // Due in an earlier pump() already.
+        };
+
+        static bool sameData(const Frame& a, const Frame& b) {
+            return a.id == b.id && a.length == b.length && a.extended == b.extended
+                   && std::memcmp(a.data, b.data, a.length) == 0;
+        }
+
+        bool isDue(std::size_t index, uint32_t now) const {
+            const Slot& slot = slots_[index];
+            return slot.active && slot.pending && static_cast<int32_t>(now - slot.due) >= 0;
+        }
+
+        std::size_t nextDue(uint32_t now) const {
+            std::size_t best = Classes;
+            for (std::size_t i = 0; i < Classes; ++i) {
+                if (isDue(i, now) && (best == Classes || classes_[i].priority < classes_[best].priority)) {
+                    best = i;
+                }
+            }
+            return best;
+        }
+
+        // Sent or dropped: an event class is finished, a periodic one is due again a period later.
+        void done(std::size_t index, uint32_t now) {
+            Slot& slot = slots_[index];
+            slot.tried = false;
+            const uint32_t period = classes_[index].periodMicros;
+            if (period == 0) {
+                slot.active = false;
+                slot.pending = false;
+                return;
+            }
+            slot.due += period;
+            if (static_cast<int32_t>(now - slot.due) >= 0) {
+                slot.due = now + period;  // Fell a period behind: keep the rhythm from now, no burst to catch up.
+            }
+        }
+
+        std::array<TxClass, Classes> classes_;
+        Slot slots_[Classes]{};
+        TxCounters counters_[Classes]{};
+    };
+
+    /**
+     * Bus for TxScheduler::pump() on top of a driver: Message is its frame type (CAN_message_t for FlexCAN_T4,
+     * with id, len, flags.extended and buf), and Driver::write(Message) returns more than 0 when it took it.
+    */
+    template<typename Message, typename Driver>
+    class DriverBus {
+    public:
+        explicit DriverBus(Driver& driver) : driver_(driver) {}
+
+        bool write(const Frame& frame) {
+            Message message;
+            message.id = frame.id;
+            message.len = frame.length;
+            message.flags.extended = frame.extended;
+            std::memcpy(message.buf, frame.data, sizeof(frame.data));
+            return driver_.write(message) > 0;
+        }
+
+    private:
+        Driver& driver_;
+    };
+}
+}
+
+#endif // KMK_CAN_TX_H
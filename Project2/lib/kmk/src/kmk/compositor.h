@@ -0,0 +1,134 @@
+#ifndef KMK_COMPOSITOR_H
+#define KMK_COMPOSITOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "ssd1306_buffer.h"
+
+namespace kmk
+{
+namespace ssd1306
+{
+    /**
+     * Two layers on one framebuffer: a static background that is rasterized once and kept here, and dynamic
+     * content drawn straight into the frame on top of it. Whatever dynamic content covered last frame is
+     * registered with track(), and compose() copies the background back over exactly those spans (memcpy per
+     * page), so a frame costs a few bytes per moving object instead of clearing and redrawing the whole screen.
+     *
+     * Dirty areas are kept as one column span per page, the same granularity DiffFlusher sends with.
+    */
+    template<int16_t Width = 128, int16_t Height = 64>
+    class Compositor {
+    public:
+        // pageHeight as a signed number, for page arithmetic on the signed coordinates.
+        static constexpr int16_t rowsPerPage = static_cast<int16_t>(pageHeight);
+        static constexpr int16_t pages = (Height + rowsPerPage - 1) / rowsPerPage;
+
+        Compositor() { invalidate(); }
+
+        /**
+         * Takes the current frame as the new background, e.g. after drawing the static parts of a screen
+         * into the display buffer. The frame already shows it, so nothing is left to restore.
+        */
+        void captureBackground(const uint8_t* frame) {
+            std::memcpy(background_, frame, sizeof(background_));
+            clear();
+        }
+
+        const uint8_t* background() const { return background_; }
+
+        /**
+         * Restores the area (x, y, w, h) from the background at the next compose(). Used for the dynamic
+         * objects drawn this frame, and for anything that should be erased before the next frame.
+        */
+        void track(int16_t x, int16_t y, int16_t w, int16_t h) {
+            if (!clip(x, y, w, h)) {
+                return;
+            }
+            for (int16_t page = y / rowsPerPage; page <= (y + h - 1) / rowsPerPage; ++page) {
+                Span& span = dirty_[page];
+                if (x < span.first) {
+                    span.first = x;
+                }
+                if (x + w - 1 > span.last) {
+                    span.last = static_cast<int16_t>(x + w - 1);
+                }
+            }
+        }
+
+        /**
+         * Copies the background over the area (x, y, w, h) of frame right away, for content that is redrawn
+         * in place only when it changes (e.g. a number). Whole pages are restored, y is rounded to them.
+        */
+        void restore(uint8_t* frame, int16_t x, int16_t y, int16_t w, int16_t h) const {
+            if (!clip(x, y, w, h)) {
+                return;
+            }
+            for (int16_t page = y / rowsPerPage; page <= (y + h - 1) / rowsPerPage; ++page) {
+                const std::size_t offset = page * Width + x;
+                std::memcpy(frame + offset, background_ + offset, w);
+            }
+        }
+
+        // The whole frame is restored at the next compose().
+        void invalidate() { track(0, 0, Width, Height); }
+
+        /**
+         * Copies the background over every tracked span of frame and starts a new frame with nothing tracked.
+         * Returns the number of bytes restored.
+        */
+        std::size_t compose(uint8_t* frame) {
+            std::size_t restored = 0;
+            for (int16_t page = 0; page < pages; ++page) {
+                const Span& span = dirty_[page];
+                if (span.first > span.last) {
+                    continue;
+                }
+                const std::size_t offset = page * Width + span.first;
+                const std::size_t count = span.last - span.first + 1;
+                std::memcpy(frame + offset, background_ + offset, count);
+                restored += count;
+            }
+            clear();
+            return restored;
+        }
+
+    private:
+        static bool clip(int16_t& x, int16_t& y, int16_t& w, int16_t& h) {
+            if (x < 0) {
+                w += x;
+                x = 0;
+            }
+            if (y < 0) {
+                h += y;
+                y = 0;
+            }
+            if (x + w > Width) {
+                w = Width - x;
+            }
+            if (y + h > Height) {
+                h = Height - y;
+            }
+            return w > 0 && h > 0;
+        }
+
+        struct Span {
+            int16_t first;
+            int16_t last;
+        };
+
+        void clear() {
+            for (Span& span : dirty_) {
+                span = {Width, -1};
+            }
+        }
+
+        uint8_t background_[Width * pages]{};
+        Span dirty_[pages];
+    };
+}
+}
+
+#endif // KMK_COMPOSITOR_H
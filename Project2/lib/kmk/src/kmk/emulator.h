@@ -0,0 +1,426 @@
+#ifndef KMK_EMULATOR_H
+#define KMK_EMULATOR_H
+
+// Host-only stand-in for the SSD1306 panel and the Adafruit_SSD1306/Adafruit_GFX calls the sketches use,
+// so drawing code can run, be compared against golden images and have its cost counted on a PC.
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "progmem.h"
+
+#ifndef SSD1306_BLACK
+#define SSD1306_BLACK 0
+#define SSD1306_WHITE 1
+#define SSD1306_INVERSE 2
+#define SSD1306_SWITCHCAPVCC 0x02
+#endif
+
+namespace kmk
+{
+namespace emulator
+{
+    /**
+     * What the SSD1306 controller does with the bytes it receives: command parsing for the addressing window,
+     * invert and on/off, and the graphics RAM the data writes go into. Works as the Link for DiffFlusher.
+    */
+    class Panel {
+    public:
+        static constexpr int16_t width = 128;
+        static constexpr int16_t pages = 8;
+        static constexpr int16_t height = pages * 8;
+
+        void command(const uint8_t* bytes, std::size_t count) {
+            commandBytes_ += count;
+            for (std::size_t i = 0; i < count; ++i) {
+                commandByte(bytes[i]);
+            }
+        }
+
+        void data(const uint8_t* bytes, std::size_t count) {
+            dataBytes_ += count;
+            for (std::size_t i = 0; i < count; ++i) {
+                ram_[page_ * width + column_] = bytes[i];
+                if (++column_ > lastColumn_) {
+                    column_ = firstColumn_;
+                    if (++page_ > lastPage_) {
+                        page_ = firstPage_;
+                    }
+                }
+            }
+        }
+
+        /**
+         * Pixel as seen on the glass, with invert and display on/off applied.
+        */
+        bool pixel(int16_t x, int16_t y) const {
+            if (!on_) {
+                return false;
+            }
+            const bool lit = (ram_[(y / 8) * width + x] >> (y % 8)) & 1;
+            return lit != inverted_;
+        }
+
+        const uint8_t* ram() const { return ram_; }
+        bool inverted() const { return inverted_; }
+
+        std::size_t dataBytes() const { return dataBytes_; }
+        std::size_t commandBytes() const { return commandBytes_; }
+        void resetCounters() { dataBytes_ = commandBytes_ = 0; }
+
+        /**
+         * Simulated SPI clock: the time everything received since resetCounters() takes on the bus,
+         * 8 clocks per byte. The default matches kmk::ssd1306::SpiLink.
+        */
+        void setClock(uint32_t hz) { clockHz_ = hz; }
+        uint64_t transferNanos() const {
+            return static_cast<uint64_t>(dataBytes_ + commandBytes_) * 8u * 1000000000u / clockHz_;
+        }
+
+        /**
+         * The visible image as a binary PBM (P4), 1 = lit like the res/ files.
+        */
+        std::string pbm() const {
+            std::string out = "P4\n" + std::to_string(width) + " " + std::to_string(height) + "\n";
+            for (int16_t y = 0; y < height; ++y) {
+                for (int16_t x = 0; x < width; x += 8) {
+                    uint8_t byte = 0;
+                    for (int16_t bit = 0; bit < 8; ++bit) {
+                        byte = static_cast<uint8_t>(byte | (pixel(x + bit, y) ? 0x80 >> bit : 0));
+                    }
+                    out.push_back(static_cast<char>(byte));
+                }
+            }
+            return out;
+        }
+
+    private:
+        static std::size_t argumentCount(uint8_t command) {
+            switch (command) {
+                case 0x21: case 0x22:
+                    return 2;
+                case 0x20: case 0x81: case 0x8D: case 0xA8: case 0xD3: case 0xD5: case 0xD9: case 0xDA: case 0xDB:
+                    return 1;
+                default:
+                    return 0;
+            }
+        }
+
+        // Commands can be split over several transfers (Adafruit sends most of them one byte at a time).
+        void commandByte(uint8_t byte) {
+            if (argumentsLeft_ == 0) {
+                pending_ = byte;
+                argumentsLeft_ = argumentCount(byte);
+                argumentIndex_ = 0;
+                if (argumentsLeft_ == 0) {
+                    execute();
+                }
+                return;
+            }
+            arguments_[argumentIndex_++] = byte;
+            if (--argumentsLeft_ == 0) {
+                execute();
+            }
+        }
+
+        void execute() {
+            switch (pending_) {
+                case 0x21:
+                    firstColumn_ = std::min<int16_t>(arguments_[0] & 0x7F, width - 1);
+                    lastColumn_ = std::min<int16_t>(arguments_[1] & 0x7F, width - 1);
+                    column_ = firstColumn_;
+                    break;
+                case 0x22:
+                    firstPage_ = std::min<int16_t>(arguments_[0] & 0x07, pages - 1);
+                    lastPage_ = std::min<int16_t>(arguments_[1] & 0x07, pages - 1);
+                    page_ = firstPage_;
+                    break;
+                case 0xA6: inverted_ = false; break;
+                case 0xA7: inverted_ = true; break;
+                case 0xAE: on_ = false; break;
+                case 0xAF: on_ = true; break;
+                default: break;
+            }
+        }
+
+        uint8_t ram_[width * pages]{};
+        int16_t firstColumn_{0}, lastColumn_{width - 1}, column_{0};
+        int16_t firstPage_{0}, lastPage_{pages - 1}, page_{0};
+        bool inverted_{false};
+        bool on_{true};
+
+        uint8_t pending_{0};
+        uint8_t arguments_[2]{};
+        std::size_t argumentsLeft_{0};
+        std::size_t argumentIndex_{0};
+
+        std::size_t dataBytes_{0};
+        std::size_t commandBytes_{0};
+        uint32_t clockHz_{8000000};
+    };
+
+    /**
+     * The Adafruit_SSD1306 subset the sketches use, drawing into the same page-major buffer with the same
+     * algorithms, so frames match the Teensy pixel for pixel. pixelsTouched() counts every pixel write
+     * (including ones that leave the pixel unchanged), a rough measure of the drawing work.
+     *
+     * Text uses Adafruit's classic 6x8 cell; the 5 column bytes per glyph are given with setClassicFont(),
+     * since the font table is not part of this library.
+    */
+    class Display {
+    public:
+        Display(int16_t width = Panel::width, int16_t height = Panel::height)
+            : width_(width), height_(height), buffer_(static_cast<std::size_t>(width * ((height + 7) / 8)), 0) {}
+
+        bool begin(uint8_t = SSD1306_SWITCHCAPVCC) {
+            const uint8_t on[] = {0x20, 0x00, 0xA6, 0xAF};
+            panel_.command(on, sizeof(on));
+            panel_.resetCounters();
+            return true;
+        }
+
+        int16_t width() const { return width_; }
+        int16_t height() const { return height_; }
+        uint8_t* getBuffer() { return buffer_.data(); }
+        Panel& panel() { return panel_; }
+        const Panel& panel() const { return panel_; }
+
+        std::size_t pixelsTouched() const { return pixelsTouched_; }
+        void resetCounters() {
+            pixelsTouched_ = 0;
+            panel_.resetCounters();
+        }
+
+        // Sends the whole buffer, like Adafruit_SSD1306::display().
+        void display() {
+            const uint8_t window[] = {0x22, 0x00, 0xFF, 0x21, 0x00, static_cast<uint8_t>(width_ - 1)};
+            panel_.command(window, sizeof(window));
+            panel_.data(buffer_.data(), buffer_.size());
+        }
+
+        void invertDisplay(bool invert) {
+            const uint8_t command = invert ? 0xA7 : 0xA6;
+            panel_.command(&command, 1);
+        }
+
+        void clearDisplay() { std::fill(buffer_.begin(), buffer_.end(), 0); }
+
+        void drawPixel(int16_t x, int16_t y, uint16_t color) {
+            if (x < 0 || y < 0 || x >= width_ || y >= height_) {
+                return;
+            }
+            ++pixelsTouched_;
+            uint8_t& byte = buffer_[static_cast<std::size_t>(x + (y / 8) * width_)];
+            const uint8_t bit = static_cast<uint8_t>(1 << (y & 7));
+            switch (color) {
+                case SSD1306_WHITE: byte = static_cast<uint8_t>(byte | bit); break;
+                case SSD1306_BLACK: byte = static_cast<uint8_t>(byte & ~bit); break;
+                case SSD1306_INVERSE: byte = static_cast<uint8_t>(byte ^ bit); break;
+                default: break;
+            }
+        }
+
+        void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
+            for (int16_t i = 0; i < w; ++i) {
+                drawPixel(x + i, y, color);
+            }
+        }
+
+        void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
+            for (int16_t i = 0; i < h; ++i) {
+                drawPixel(x, y + i, color);
+            }
+        }
+
+        void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+            for (int16_t i = x; i < x + w; ++i) {
+                drawFastVLine(i, y, h, color);
+            }
+        }
+
+        void drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+            drawFastHLine(x, y, w, color);
+            drawFastHLine(x, y + h - 1, w, color);
+            drawFastVLine(x, y, h, color);
+            drawFastVLine(x + w - 1, y, h, color);
+        }
+
+        // Same midpoint algorithm as Adafruit_GFX::fillCircle().
+        void fillCircle(int16_t x0, int16_t y0, int16_t r, uint16_t color) {
+            drawFastVLine(x0, y0 - r, 2 * r + 1, color);
+            int16_t f = 1 - r;
+            int16_t ddFx = 1;
+            int16_t ddFy = -2 * r;
+            int16_t x = 0;
+            int16_t y = r;
+            int16_t px = x;
+            int16_t py = y;
+            while (x < y) {
+                if (f >= 0) {
+                    --y;
+                    ddFy += 2;
+                    f += ddFy;
+                }
+                ++x;
+                ddFx += 2;
+                f += ddFx;
+                if (x < y + 1) {
+                    drawFastVLine(x0 + x, y0 - y, 2 * y + 1, color);
+                    drawFastVLine(x0 - x, y0 - y, 2 * y + 1, color);
+                }
+                if (y != py) {
+                    drawFastVLine(x0 + py, y0 - px, 2 * px + 1, color);
+                    drawFastVLine(x0 - py, y0 - px, 2 * px + 1, color);
+                    py = y;
+                }
+                px = x;
+            }
+        }
+
+        // Row-major, MSB first, like Adafruit_GFX::drawBitmap(). Only set bits are drawn.
+        void drawBitmap(int16_t x, int16_t y, const uint8_t* bitmap, int16_t w, int16_t h, uint16_t color) {
+            const int16_t byteWidth = (w + 7) / 8;
+            uint8_t byte = 0;
+            for (int16_t j = 0; j < h; ++j, ++y) {
+                for (int16_t i = 0; i < w; ++i) {
+                    byte = (i & 7) ? static_cast<uint8_t>(byte << 1) : pgm_read_byte(&bitmap[j * byteWidth + i / 8]);
+                    if (byte & 0x80) {
+                        drawPixel(x + i, y, color);
+                    }
+                }
+            }
+        }
+
+        void drawBitmap(int16_t x, int16_t y, const uint8_t* bitmap, int16_t w, int16_t h, uint16_t color, uint16_t background) {
+            const int16_t byteWidth = (w + 7) / 8;
+            uint8_t byte = 0;
+            for (int16_t j = 0; j < h; ++j, ++y) {
+                for (int16_t i = 0; i < w; ++i) {
+                    byte = (i & 7) ? static_cast<uint8_t>(byte << 1) : pgm_read_byte(&bitmap[j * byteWidth + i / 8]);
+                    drawPixel(x + i, y, (byte & 0x80) ? color : background);
+                }
+            }
+        }
+
+        /**
+         * 5 column bytes (LSB = top) per character, for the count characters starting at first.
+        */
+        void setClassicFont(const uint8_t* columns, uint8_t first, uint16_t count) {
+            font_ = columns;
+            fontFirst_ = first;
+            fontCount_ = count;
+        }
+
+        void setCursor(int16_t x, int16_t y) {
+            cursorX_ = x;
+            cursorY_ = y;
+        }
+        int16_t getCursorX() const { return cursorX_; }
+        int16_t getCursorY() const { return cursorY_; }
+        void setTextSize(uint8_t size) { textSize_ = size > 0 ? size : 1; }
+        void setTextColor(uint16_t color) { textColor_ = textBackground_ = color; }
+        void setTextColor(uint16_t color, uint16_t background) {
+            textColor_ = color;
+            textBackground_ = background;
+        }
+        void setTextWrap(bool wrap) { wrap_ = wrap; }
+
+        std::size_t write(uint8_t c) {
+            if (c == '\n') {
+                cursorX_ = 0;
+                cursorY_ += textSize_ * 8;
+            } else if (c != '\r') {
+                if (wrap_ && cursorX_ + textSize_ * 6 > width_) {
+                    cursorX_ = 0;
+                    cursorY_ += textSize_ * 8;
+                }
+                drawChar(cursorX_, cursorY_, c);
+                cursorX_ += textSize_ * 6;
+            }
+            return 1;
+        }
+
+        std::size_t print(const char* text) {
+            std::size_t n = 0;
+            while (*text) {
+                n += write(static_cast<uint8_t>(*text++));
+            }
+            return n;
+        }
+        std::size_t print(const std::string& text) { return print(text.c_str()); }
+        std::size_t print(char c) { return write(static_cast<uint8_t>(c)); }
+
+        template<typename Integer, typename = std::enable_if_t<std::is_integral_v<Integer>>>
+        std::size_t print(Integer value, int base = 10) {
+            char digits[sizeof(Integer) * 8 + 2];
+            char* end = digits + sizeof(digits);
+            char* p = end;
+            *--p = '\0';
+            const bool negative = std::is_signed_v<Integer> && value < 0 && base == 10;
+            auto magnitude = static_cast<std::make_unsigned_t<Integer>>(negative ? -value : value);
+            do {
+                const auto digit = magnitude % base;
+                *--p = static_cast<char>(digit < 10 ? '0' + digit : 'A' + digit - 10);
+                magnitude /= base;
+            } while (magnitude != 0);
+            if (negative) {
+                *--p = '-';
+            }
+            return print(p);
+        }
+
+        template<typename T>
+        std::size_t println(const T& value) { return print(value) + write('\n'); }
+        template<typename Integer, typename = std::enable_if_t<std::is_integral_v<Integer>>>
+        std::size_t println(Integer value, int base) { return print(value, base) + write('\n'); }
+        std::size_t println() { return write('\n'); }
+
+    private:
+        // Adafruit_GFX::drawChar() for the built-in font.
+        void drawChar(int16_t x, int16_t y, uint8_t c) {
+            if (x >= width_ || y >= height_ || x + 6 * textSize_ - 1 < 0 || y + 8 * textSize_ - 1 < 0) {
+                return;
+            }
+            const bool known = font_ != nullptr && c >= fontFirst_ && c < fontFirst_ + fontCount_;
+            for (int16_t i = 0; i < 6; ++i) {
+                uint8_t line = (known && i < 5) ? pgm_read_byte(&font_[(c - fontFirst_) * 5 + i]) : 0;
+                for (int16_t j = 0; j < 8; ++j, line >>= 1) {
+                    const bool set = line & 1;
+                    if (!set && textBackground_ == textColor_) {
+                        continue;
+                    }
+                    const uint16_t color = set ? textColor_ : textBackground_;
+                    if (textSize_ == 1) {
+                        drawPixel(x + i, y + j, color);
+                    } else {
+                        fillRect(x + i * textSize_, y + j * textSize_, textSize_, textSize_, color);
+                    }
+                }
+            }
+        }
+
+        int16_t width_;
+        int16_t height_;
+        std::vector<uint8_t> buffer_;
+        Panel panel_;
+        std::size_t pixelsTouched_{0};
+
+        const uint8_t* font_{nullptr};
+        uint8_t fontFirst_{0};
+        uint16_t fontCount_{0};
+        int16_t cursorX_{0};
+        int16_t cursorY_{0};
+        uint8_t textSize_{1};
+        uint16_t textColor_{SSD1306_WHITE};
+        uint16_t textBackground_{SSD1306_WHITE};
+        bool wrap_{true};
+    };
+}
+}
+
+#endif // KMK_EMULATOR_H
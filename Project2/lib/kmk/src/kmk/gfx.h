@@ -0,0 +1,214 @@
+#ifndef KMK_GFX_H
+#define KMK_GFX_H
+
+#include <array>
+#include <cstdint>
+
+#include "ssd1306_buffer.h"
+
+namespace kmk
+{
+namespace ssd1306
+{
+    // Same values as SSD1306_BLACK/WHITE/INVERSE, so static_cast<Color>(SSD1306_WHITE) works.
+    enum class Color : uint8_t {
+        Black = 0,
+        White = 1,
+        Inverse = 2,
+    };
+
+    /**
+     * Applies mask to count consecutive framebuffer bytes (columns of one page). The switch is outside
+     * the loop, so each column is a single byte operation.
+    */
+    inline void applyMask(uint8_t* bytes, int16_t count, uint8_t mask, Color color) {
+        switch (color) {
+            case Color::White:
+                for (int16_t i = 0; i < count; ++i) {
+                    bytes[i] = static_cast<uint8_t>(bytes[i] | mask);
+                }
+                break;
+            case Color::Black:
+                for (int16_t i = 0; i < count; ++i) {
+                    bytes[i] = static_cast<uint8_t>(bytes[i] & ~mask);
+                }
+                break;
+            case Color::Inverse:
+                for (int16_t i = 0; i < count; ++i) {
+                    bytes[i] = static_cast<uint8_t>(bytes[i] ^ mask);
+                }
+                break;
+        }
+    }
+
+    // Rows first..last (inclusive, within one page) as a byte mask.
+    constexpr uint8_t rowMask(int16_t first, int16_t last) {
+        return static_cast<uint8_t>((0xFFu << (first & 7)) & (0xFFu >> (7 - (last & 7))));
+    }
+
+    /**
+     * Fills w x h pixels at (x, y), clipped to the buffer. One mask per page, then one byte
+     * operation per column and page instead of one drawPixel per pixel.
+    */
+    inline void fillRect(uint8_t* buffer, int16_t bufferWidth, int16_t bufferHeight,
+                         int16_t x, int16_t y, int16_t w, int16_t h, Color color) {
+        int16_t x0 = x < 0 ? 0 : x;
+        int16_t y0 = y < 0 ? 0 : y;
+        const int16_t x1 = x + w > bufferWidth ? bufferWidth : x + w;
+        const int16_t y1 = y + h > bufferHeight ? bufferHeight : y + h;
+        if (x0 >= x1 || y0 >= y1) {
+            return;
+        }
+        for (int16_t page = y0 / 8; page <= (y1 - 1) / 8; ++page) {
+            const int16_t first = page * 8 > y0 ? page * 8 : y0;
+            const int16_t last = page * 8 + 7 < y1 - 1 ? page * 8 + 7 : y1 - 1;
+            applyMask(buffer + page * bufferWidth + x0, x1 - x0, rowMask(first, last), color);
+        }
+    }
+
+    inline void fillVSpan(uint8_t* buffer, int16_t bufferWidth, int16_t bufferHeight,
+                          int16_t x, int16_t y, int16_t h, Color color) {
+        fillRect(buffer, bufferWidth, bufferHeight, x, y, 1, h, color);
+    }
+
+    /**
+     * Filled circle with the same midpoint algorithm, and so the same pixels, as Adafruit_GFX::fillCircle(),
+     * but each vertical line is a masked byte per page.
+    */
+    inline void fillCircle(uint8_t* buffer, int16_t bufferWidth, int16_t bufferHeight,
+                           int16_t x0, int16_t y0, int16_t r, Color color) {
+        fillVSpan(buffer, bufferWidth, bufferHeight, x0, y0 - r, 2 * r + 1, color);
+        int16_t f = 1 - r;
+        int16_t ddFx = 1;
+        int16_t ddFy = -2 * r;
+        int16_t x = 0;
+        int16_t y = r;
+        int16_t px = x;
+        int16_t py = y;
+        while (x < y) {
+            if (f >= 0) {
+                --y;
+                ddFy += 2;
+                f += ddFy;
+            }
+            ++x;
+            ddFx += 2;
+            f += ddFx;
+            if (x < y + 1) {
+                fillVSpan(buffer, bufferWidth, bufferHeight, x0 + x, y0 - y, 2 * y + 1, color);
+                fillVSpan(buffer, bufferWidth, bufferHeight, x0 - x, y0 - y, 2 * y + 1, color);
+            }
+            if (y != py) {
+                fillVSpan(buffer, bufferWidth, bufferHeight, x0 + py, y0 - px, 2 * px + 1, color);
+                fillVSpan(buffer, bufferWidth, bufferHeight, x0 - py, y0 - px, 2 * px + 1, color);
+                py = y;
+            }
+            px = x;
+        }
+    }
+
+    /**
+     * Pre-rasterized shape up to 25 pixels high, one 32 bit column mask per column (bit 0 = top row).
+     * Drawing it at any y is a shift per column, then up to four masked page bytes.
+    */
+    template<int16_t Width>
+    struct ColumnMask {
+        std::array<uint32_t, Width> columns;
+        int16_t height;
+
+        static constexpr int16_t width = Width;
+    };
+
+    /**
+     * Half height of each column of a filled circle, as drawn by fillCircle() (column 0 is the center).
+    */
+    template<int16_t R>
+    constexpr std::array<int16_t, R + 1> circleHalfHeights() {
+        std::array<int16_t, R + 1> half{};
+        half[0] = R;
+        int16_t f = 1 - R;
+        int16_t ddFx = 1;
+        int16_t ddFy = -2 * R;
+        int16_t x = 0;
+        int16_t y = R;
+        int16_t px = x;
+        int16_t py = y;
+        while (x < y) {
+            if (f >= 0) {
+                --y;
+                ddFy += 2;
+                f += ddFy;
+            }
+            ++x;
+            ddFx += 2;
+            f += ddFx;
+            if (x < y + 1 && y > half[x]) {
+                half[x] = y;
+            }
+            if (y != py) {
+                if (px > half[py]) {
+                    half[py] = px;
+                }
+                py = y;
+            }
+            px = x;
+        }
+        return half;
+    }
+
+    /**
+     * The filled circle of radius R as a (2R + 1) x (2R + 1) mask, built at compile time.
+     * Draw it at (cx - R, cy - R) for the circle fillCircle(cx, cy, R) would give.
+    */
+    template<int16_t R>
+    constexpr ColumnMask<2 * R + 1> circleMask() {
+        static_assert(2 * R + 1 <= 25, "The mask is shifted within 32 bits, keep the circle at most 25 pixels high");
+        constexpr auto half = circleHalfHeights<R>();
+        ColumnMask<2 * R + 1> mask{{}, 2 * R + 1};
+        for (int16_t dx = -R; dx <= R; ++dx) {
+            const int16_t h = half[dx < 0 ? -dx : dx];
+            mask.columns[dx + R] = ((1u << (2 * h + 1)) - 1u) << (R - h);
+        }
+        return mask;
+    }
+
+    template<int16_t W, int16_t H>
+    constexpr ColumnMask<W> rectMask() {
+        static_assert(H <= 25, "The mask is shifted within 32 bits, keep it at most 25 pixels high");
+        ColumnMask<W> mask{{}, H};
+        for (auto& column : mask.columns) {
+            column = (1u << H) - 1u;
+        }
+        return mask;
+    }
+
+    template<int16_t W>
+    inline void drawMask(uint8_t* buffer, int16_t bufferWidth, int16_t bufferHeight,
+                         int16_t x, int16_t y, const ColumnMask<W>& mask, Color color) {
+        if (x >= bufferWidth || y >= bufferHeight || x + W <= 0 || y + mask.height <= 0) {
+            return;
+        }
+        const int16_t bufferPages = (bufferHeight + 7) / 8;
+        const int16_t pageY = y >= 0 ? y / 8 : -((7 - y) / 8);  // Floor division, like blitPageMajor().
+        const uint8_t shift = static_cast<uint8_t>(y - pageY * 8);
+        const int16_t spanPages = (shift + mask.height + 7) / 8;
+        const int16_t x0 = x < 0 ? 0 : x;
+        const int16_t x1 = x + W > bufferWidth ? bufferWidth : x + W;
+
+        for (int16_t column = x0; column < x1; ++column) {
+            // 64 bits, the shifted mask can reach past bit 31.
+            const uint64_t bits = static_cast<uint64_t>(mask.columns[column - x]) << shift;
+            for (int16_t i = 0; i < spanPages; ++i) {
+                const int16_t page = pageY + i;
+                const uint8_t pageMask = static_cast<uint8_t>(bits >> (8 * i));
+                if (page < 0 || page >= bufferPages || pageMask == 0) {
+                    continue;
+                }
+                applyMask(buffer + page * bufferWidth + column, 1, pageMask, color);
+            }
+        }
+    }
+}
+}
+
+#endif // KMK_GFX_H
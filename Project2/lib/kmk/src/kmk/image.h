@@ -0,0 +1,98 @@
+#ifndef KMK_IMAGE_H
+#define KMK_IMAGE_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+namespace kmk
+{
+    /**
+     * This part is based on C++ features template metaprogramming with variadic templates and parameter pack expansion.
+     * (Not something you need to learn for MAS245 or MAS417).
+     *
+     * Minimum C++ version for this is C++17, so the same header works in the Teensy build and in the native tools.
+     *
+     * Enables compile-time initialization of C++ std::array from C-style array, and also conversions. No run-time penalty,
+     * and also memory efficient. The firmware packs its images from the GIMP exports at compile time with these.
+    */
+    template<std::size_t N, std::size_t... Indices>
+    constexpr auto to_array_impl(const unsigned char (&arr)[N], std::index_sequence<Indices...>) {
+        return std::array<uint8_t, N>{arr[Indices]...};
+    }
+
+    template<std::size_t N>
+    constexpr auto to_array(const unsigned char (&arr)[N]) {
+        return to_array_impl(arr, std::make_index_sequence<N>{});
+    }
+
+    /**
+     * Size in bytes of a w x h image packed row-major, every row padded to whole bytes as drawBitmap expects.
+    */
+    constexpr std::size_t rowMajorSize(std::size_t width, std::size_t height) {
+        return ((width + 7) / 8) * height;
+    }
+
+    /**
+     * Size in bytes of a w x h image in the SSD1306 page-major layout, height padded to whole pages.
+    */
+    constexpr std::size_t pageMajorSize(std::size_t width, std::size_t height) {
+        return width * ((height + 7) / 8);
+    }
+
+    /**
+     * Packs one byte per pixel (non-zero is lit) into row-major, MSB first bytes, the Adafruit_GFX::drawBitmap layout.
+     * out must hold rowMajorSize(width, height) zeroed bytes. Works at compile time and at run time.
+    */
+    constexpr void packRowMajor(const uint8_t* pixels, std::size_t width, std::size_t height, uint8_t* out) {
+        const std::size_t byteWidth = (width + 7) / 8;
+        for (std::size_t y = 0; y < height; ++y) {
+            for (std::size_t x = 0; x < width; ++x) {
+                if (pixels[y * width + x]) {
+                    out[y * byteWidth + x / 8] |= static_cast<uint8_t>(0x80u >> (x % 8)); // Fill in leftmost (MSB) bit first.
+                }
+            }
+        }
+    }
+
+    /**
+     * Transposes one byte per pixel into the SSD1306 page-major layout: 8 rows per page, one byte per column,
+     * top row in the LSB. The result can be copied straight into Adafruit_SSD1306::getBuffer() instead of
+     * being drawn pixel by pixel. out must hold pageMajorSize(width, height) zeroed bytes.
+    */
+    constexpr void packPageMajor(const uint8_t* pixels, std::size_t width, std::size_t height, uint8_t* out) {
+        for (std::size_t y = 0; y < height; ++y) {
+            for (std::size_t x = 0; x < width; ++x) {
+                if (pixels[y * width + x]) {
+                    out[(y / 8) * width + x] |= static_cast<uint8_t>(1u << (y % 8));
+                }
+            }
+        }
+    }
+
+    /**
+     * Packs one byte per pixel into row-major, MSB first bytes (the Adafruit_GFX::drawBitmap layout).
+    */
+    template<std::size_t N>
+    constexpr auto compressBinaryArray(const std::array<uint8_t, N>& data) {
+        static_assert(N % 8 == 0, "Row-major packing needs whole bytes");
+        std::array<uint8_t, N / 8> compressedArray{};
+        for (std::size_t i = 0; i < N; i += 8) {
+            for (std::size_t j = 0; j < 8; ++j) {
+                compressedArray[i / 8] |= ((data[i + j] != 0) << (7 - j)); // Fill in leftmost (MSB) bit first.
+            }
+        }
+        return compressedArray;
+    }
+
+    template<std::size_t Width, std::size_t Height, std::size_t N>
+    constexpr auto toPageMajor(const std::array<uint8_t, N>& data) {
+        static_assert(N == Width * Height, "Pixel count does not match the image size");
+        std::array<uint8_t, pageMajorSize(Width, Height)> pageArray{};
+        packPageMajor(data.data(), Width, Height, pageArray.data());
+        return pageArray;
+    }
+}
+
+#endif // KMK_IMAGE_H
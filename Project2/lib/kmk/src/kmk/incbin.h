@@ -0,0 +1,25 @@
+#ifndef KMK_INCBIN_H
+#define KMK_INCBIN_H
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Pulls a binary file into read-only memory with the assembler's .incbin, so large assets never go through
+ * the C++ parser. Defines symbol[] (and symbol_end[]) with C linkage, use it at file scope in one source file.
+ *
+ * The path is resolved by the assembler, relative to the directory the build runs in (the PlatformIO project).
+*/
+#define KMK_INCBIN(symbol, path)                    \
+    __asm__(".section .rodata\n"                    \
+            ".global " #symbol "\n"                 \
+            ".balign 4\n"                           \
+            #symbol ":\n"                           \
+            ".incbin \"" path "\"\n"                \
+            ".global " #symbol "_end\n"             \
+            #symbol "_end:\n"                       \
+            ".previous\n");                         \
+    extern "C" const uint8_t symbol[];              \
+    extern "C" const uint8_t symbol##_end[]
+
+#endif // KMK_INCBIN_H
@@ -0,0 +1,156 @@
+#ifndef KMK_LOG_H
+#define KMK_LOG_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <type_traits>
+
+#include "packet.h"
+
+namespace kmk
+{
+namespace log
+{
+    /**
+     * Deferred binary logging. Instead of formatting text on the target, a record is the number of a format
+     * string, a micros() time stamp and the raw arguments, 32 bits each, sent as one 'L' packet (kmk/packet.h):
+     *   message, time stamp (4 bytes), arguments (4 bytes each), all LSB first.
+     * Target and host share the table of format strings, and the host does the printf work.
+    */
+    constexpr uint8_t packetType = 'L';
+    constexpr std::size_t headerSize = 5;
+    constexpr std::size_t maxArgs = 8;
+
+    inline void put32(uint8_t* out, uint32_t value) {
+        out[0] = static_cast<uint8_t>(value);
+        out[1] = static_cast<uint8_t>(value >> 8);
+        out[2] = static_cast<uint8_t>(value >> 16);
+        out[3] = static_cast<uint8_t>(value >> 24);
+    }
+
+    inline uint32_t get32(const uint8_t* in) {
+        return in[0] | (in[1] << 8) | (static_cast<uint32_t>(in[2]) << 16) | (static_cast<uint32_t>(in[3]) << 24);
+    }
+
+    // Integers are widened to 32 bits (signed ones sign-extended), floating point goes as float.
+    template<typename T>
+    uint32_t bitsOf(T value) {
+        static_assert(std::is_arithmetic<T>::value && sizeof(T) <= 4, "Log arguments are numbers of at most 32 bits");
+        if constexpr (std::is_floating_point<T>::value) {
+            uint32_t bits;
+            const float single = static_cast<float>(value);
+            std::memcpy(&bits, &single, sizeof(bits));
+            return bits;
+        } else if constexpr (std::is_signed<T>::value) {
+            return static_cast<uint32_t>(static_cast<int32_t>(value));
+        } else {
+            return static_cast<uint32_t>(value);
+        }
+    }
+
+    /**
+     * Queues records in a kmk::packet::Channel, which may be shared with other packets, e.g. a FrameStreamer.
+     * write() copies a few bytes and never waits: when the channel is full the record is dropped and counted,
+     * so a flood of messages costs records, not frame time.
+    */
+    template<typename Channel>
+    class Logger {
+    public:
+        explicit Logger(Channel& channel) : channel_(channel) {}
+
+        template<typename... Args>
+        bool write(uint8_t message, uint32_t micros, Args... args) {
+            static_assert(sizeof...(Args) <= maxArgs, "Too many log arguments");
+            uint8_t payload[headerSize + 4 * sizeof...(Args)];
+            payload[0] = message;
+            put32(payload + 1, micros);
+            uint8_t* at = payload + headerSize;
+            ((put32(at, bitsOf(args)), at += 4), ...);
+            if (!channel_.send(packetType, payload, sizeof(payload))) {
+                ++dropped_;
+                return false;
+            }
+            return true;
+        }
+
+        uint32_t dropped() const { return dropped_; }
+
+    private:
+        Channel& channel_;
+        uint32_t dropped_{0};
+    };
+
+    /**
+     * Receiving end: prints the record in an 'L' packet's payload as text with the format string its message
+     * number picks from formats. %d and %i take a signed argument, %u %x %X %c an unsigned one, %f %e %g a
+     * float; flags, width and precision work as in printf. Returns the length like snprintf, or -1 if the
+     * record does not match the table.
+    */
+    inline int format(char* out, std::size_t size, const uint8_t* payload, std::size_t length,
+                      const char* const* formats, std::size_t formatCount) {
+        if (length < headerSize || (length - headerSize) % 4 != 0 || payload[0] >= formatCount) {
+            return -1;
+        }
+        const char* text = formats[payload[0]];
+        const uint8_t* arg = payload + headerSize;
+        const uint8_t* const end = payload + length;
+        std::size_t used = 0;
+        auto append = [&](int count) {
+            if (count > 0) {
+                used += static_cast<std::size_t>(count);
+            }
+        };
+        auto room = [&] { return used < size ? size - used : 0; };
+        while (*text != '\0') {
+            const char* percent = std::strchr(text, '%');
+            const std::size_t plain = percent ? static_cast<std::size_t>(percent - text) : std::strlen(text);
+            append(std::snprintf(out + (used < size ? used : size - 1), room(), "%.*s", static_cast<int>(plain), text));
+            if (!percent) {
+                break;
+            }
+            // One conversion: copy the spec, then format the next argument with it.
+            const std::size_t specLength = std::strspn(percent + 1, "-+ #0123456789.") + 2;
+            char spec[16];
+            if (specLength >= sizeof(spec) || percent[specLength - 1] == '\0') {
+                return -1;
+            }
+            std::memcpy(spec, percent, specLength);
+            spec[specLength] = '\0';
+            char* const where = out + (used < size ? used : size - 1);
+            const char conversion = spec[specLength - 1];
+            if (conversion == '%') {
+                append(std::snprintf(where, room(), "%%"));
+            } else if (arg == end) {
+                return -1;
+            } else {
+                const uint32_t bits = get32(arg);
+                arg += 4;
+                float single;
+                std::memcpy(&single, &bits, sizeof(single));
+                switch (conversion) {
+                    case 'd': case 'i':
+                        append(std::snprintf(where, room(), spec, static_cast<int>(static_cast<int32_t>(bits))));
+                        break;
+                    case 'u': case 'x': case 'X': case 'c':
+                        append(std::snprintf(where, room(), spec, static_cast<unsigned>(bits)));
+                        break;
+                    case 'f': case 'e': case 'g':
+                        append(std::snprintf(where, room(), spec, static_cast<double>(single)));
+                        break;
+                    default:
+                        return -1;
+                }
+            }
+            text = percent + specLength;
+        }
+        return static_cast<int>(used);
+    }
+
+    // The micros() time stamp of the record in an 'L' packet's payload.
+    inline uint32_t timestamp(const uint8_t* payload) { return get32(payload + 1); }
+}
+}
+
+#endif // KMK_LOG_H
@@ -0,0 +1,164 @@
+#ifndef KMK_PACKET_H
+#define KMK_PACKET_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "ring_buffer.h"
+
+namespace kmk
+{
+namespace packet
+{
+    /**
+     * Framing for binary data on the USB serial port, shared by everything that sends some:
+     *   0xA5 0x5A, type, payload length, payload, checksum (sum of type, length and payload).
+     * Types in use: 'S' and 'E' (kmk/stream.h), 'L' (kmk/log.h).
+     *
+     * A receiver that gets out of step (noise, a missed byte) looks for the next 0xA5 0x5A and drops packets
+     * with a wrong checksum. Bytes outside packets, such as plain text prints, are handed on as they are.
+    */
+    constexpr uint8_t sync0 = 0xA5;
+    constexpr uint8_t sync1 = 0x5A;
+    constexpr std::size_t headerSize = 4;
+    constexpr std::size_t maxPayload = 255;
+
+    /**
+     * Packets queued in a ring buffer and written out without ever waiting for the port: pump() hands the port
+     * only what it can take right now (Out needs availableForWrite() and write(bytes, count) returning the count
+     * taken, like Serial). Several senders can share one channel, packets stay whole.
+    */
+    template<typename Out, std::size_t RingSize = 4096>
+    class Channel {
+    public:
+        explicit Channel(Out& out) : out_(out) {}
+
+        /**
+         * Queues one packet, or nothing if it does not fit. Returns whether it was queued.
+        */
+        bool send(uint8_t type, const uint8_t* payload, std::size_t size) {
+            if (size > maxPayload || ring_.space() < headerSize + size + 1) {
+                return false;
+            }
+            const uint8_t header[] = {sync0, sync1, type, static_cast<uint8_t>(size)};
+            uint8_t sum = static_cast<uint8_t>(type + size);
+            for (std::size_t i = 0; i < size; ++i) {
+                sum = static_cast<uint8_t>(sum + payload[i]);
+            }
+            ring_.push(header, headerSize);
+            ring_.push(payload, size);
+            ring_.push(sum);
+            return true;
+        }
+
+        /**
+         * Writes as much of the queue as the port accepts without blocking, at most maxBytes. Call it from loop().
+        */
+        void pump(std::size_t maxBytes = RingSize) {
+            const std::size_t available = static_cast<std::size_t>(out_.availableForWrite());
+            std::size_t room = available < maxBytes ? available : maxBytes;
+            while (room > 0 && !ring_.empty()) {
+                std::size_t count = 0;
+                const uint8_t* data = ring_.contiguous(count);
+                if (count > room) {
+                    count = room;
+                }
+                const std::size_t written = out_.write(data, count);
+                ring_.consume(written);
+                if (written < count) {
+                    break;
+                }
+                room -= written;
+            }
+        }
+
+        /**
+         * Like pump(), for when everything queued has to be out first, e.g. before printing text on the same
+         * port. Returns true once the queue is empty; until then, call it again on the next pass. It never
+         * waits, so a host that stops reading holds up the text but not loop().
+        */
+        bool flush(std::size_t maxBytes = RingSize) {
+            pump(maxBytes);
+            return ring_.empty();
+        }
+
+        std::size_t queued() const { return ring_.size(); }
+
+    private:
+        Out& out_;
+        RingBuffer<uint8_t, RingSize> ring_;
+    };
+
+    /**
+     * Receiving end, one byte at a time.
+    */
+    class Parser {
+    public:
+        enum class Result : uint8_t {
+            None,     // Byte taken, nothing complete yet.
+            Packet,   // A packet with a good checksum is complete: type(), payload(), length().
+            Outside,  // The byte is not part of a packet (text), pass it on.
+            Error,    // A packet with a wrong checksum was dropped.
+        };
+
+        Result feed(uint8_t byte) {
+            switch (state_) {
+                case State::Sync0:
+                    if (byte == sync0) {
+                        state_ = State::Sync1;
+                        return Result::None;
+                    }
+                    return Result::Outside;
+                case State::Sync1:
+                    state_ = byte == sync1 ? State::Type : (byte == sync0 ? State::Sync1 : State::Sync0);
+                    return Result::None;
+                case State::Type:
+                    type_ = byte;
+                    state_ = State::Length;
+                    return Result::None;
+                case State::Length:
+                    length_ = byte;
+                    received_ = 0;
+                    state_ = length_ > 0 ? State::Payload : State::Checksum;
+                    return Result::None;
+                case State::Payload:
+                    payload_[received_++] = byte;
+                    if (received_ == length_) {
+                        state_ = State::Checksum;
+                    }
+                    return Result::None;
+                case State::Checksum: {
+                    state_ = State::Sync0;
+                    uint8_t sum = static_cast<uint8_t>(type_ + length_);
+                    for (std::size_t i = 0; i < length_; ++i) {
+                        sum = static_cast<uint8_t>(sum + payload_[i]);
+                    }
+                    if (sum != byte) {
+                        ++errors_;
+                        return Result::Error;
+                    }
+                    return Result::Packet;
+                }
+            }
+            return Result::None;
+        }
+
+        uint8_t type() const { return type_; }
+        const uint8_t* payload() const { return payload_; }
+        uint8_t length() const { return length_; }
+        std::size_t errors() const { return errors_; }
+
+    private:
+        enum class State : uint8_t { Sync0, Sync1, Type, Length, Payload, Checksum };
+
+        State state_{State::Sync0};
+        uint8_t type_{0};
+        uint8_t length_{0};
+        std::size_t received_{0};
+        uint8_t payload_[maxPayload]{};
+        std::size_t errors_{0};
+    };
+}
+}
+
+#endif // KMK_PACKET_H
@@ -0,0 +1,75 @@
+#ifndef KMK_PATH_H
+#define KMK_PATH_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace kmk
+{
+    struct Point {
+        int16_t x;
+        int16_t y;
+    };
+
+namespace path
+{
+    constexpr double pi = 3.14159265358979323846;
+
+    /**
+     * constexpr sine and cosine (std::sin is not constexpr). Range reduction to [-pi, pi] and a Taylor series,
+     * accurate to well below a pixel, only meant for building tables at compile time.
+    */
+    constexpr double sin(double x) {
+        while (x > pi) {
+            x -= 2 * pi;
+        }
+        while (x < -pi) {
+            x += 2 * pi;
+        }
+        double term = x;
+        double sum = x;
+        for (int n = 1; n < 12; ++n) {
+            term *= -x * x / ((2 * n) * (2 * n + 1));
+            sum += term;
+        }
+        return sum;
+    }
+
+    constexpr double cos(double x) {
+        return sin(x + pi / 2);
+    }
+
+    constexpr int16_t roundToInt16(double value) {
+        return static_cast<int16_t>(value < 0 ? value - 0.5 : value + 0.5);
+    }
+
+    /**
+     * Samples any parametric path at compile time: point(i) for i in [0, N). The table goes to flash, and walking
+     * it at run time is a load per step instead of libm calls.
+    */
+    template<std::size_t N, typename PointAt>
+    constexpr std::array<Point, N> sample(PointAt point) {
+        std::array<Point, N> points{};
+        for (std::size_t i = 0; i < N; ++i) {
+            points[i] = point(i);
+        }
+        return points;
+    }
+
+    /**
+     * N points on an ellipse around (centerX, centerY), starting at startDegrees and stepping stepDegrees.
+     * Coordinates are rounded to the nearest pixel.
+    */
+    template<std::size_t N>
+    constexpr std::array<Point, N> ellipse(int16_t centerX, int16_t centerY, int16_t radiusX, int16_t radiusY,
+                                           double startDegrees, double stepDegrees) {
+        return sample<N>([=](std::size_t i) {
+            const double radians = (startDegrees + stepDegrees * static_cast<double>(i)) * pi / 180.0;
+            return Point{roundToInt16(centerX + radiusX * cos(radians)), roundToInt16(centerY + radiusY * sin(radians))};
+        });
+    }
+}
+}
+
+#endif // KMK_PATH_H
@@ -0,0 +1,46 @@
+#ifndef KMK_PONG_H
+#define KMK_PONG_H
+
+#include <cstdint>
+
+#include "gfx.h"
+
+namespace kmk
+{
+namespace pong
+{
+    struct Geometry {
+        int16_t paddleWidth;
+        int16_t paddleHeight;
+        int16_t ballSize;
+    };
+
+    struct State {
+        int16_t leftPaddleY;
+        int16_t rightPaddleY;
+        int16_t ballX;
+        int16_t ballY;
+    };
+
+    /**
+     * Draws a Pong frame from scratch: left and right paddles at the screen edges and the square ball.
+     * Shared by both players (and the host emulator), so they render identically. The rectangles are
+     * filled with byte masks directly in the framebuffer, one or two byte operations per column.
+    */
+    template<typename Display>
+    void draw(Display& display, const Geometry& geometry, const State& state) {
+        using ssd1306::Color;
+        display.clearDisplay();
+        uint8_t* buffer = display.getBuffer();
+        const int16_t w = display.width();
+        const int16_t h = display.height();
+
+        ssd1306::fillRect(buffer, w, h, 0, state.leftPaddleY, geometry.paddleWidth, geometry.paddleHeight, Color::White);
+        ssd1306::fillRect(buffer, w, h, w - geometry.paddleWidth, state.rightPaddleY,
+                          geometry.paddleWidth, geometry.paddleHeight, Color::White);
+        ssd1306::fillRect(buffer, w, h, state.ballX, state.ballY, geometry.ballSize, geometry.ballSize, Color::White);
+    }
+}
+}
+
+#endif // KMK_PONG_H
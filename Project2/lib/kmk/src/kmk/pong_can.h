@@ -0,0 +1,51 @@
+#ifndef KMK_PONG_CAN_H
+#define KMK_PONG_CAN_H
+
+#include <cstdint>
+
+#include "can_schema.h"
+
+namespace kmk
+{
+namespace pong
+{
+    /**
+     * CAN messages between the two Pong players, declared once for both (and for the DBC export). Each player
+     * has a group number, and the paddle and state IDs are its group number plus 20 and 50. All fields are
+     * little endian, as the players always sent them.
+    */
+    constexpr uint32_t paddleId(uint8_t group) { return 20u + group; }
+    constexpr uint32_t stateId(uint8_t group) { return 50u + group; }
+    constexpr uint32_t masterId = 100;
+    constexpr uint32_t notMasterId = 101;
+
+    // The sender's own paddle, sent by the player that is not master.
+    struct Paddle {
+        int16_t y;
+
+        static constexpr auto layout = can::layout<2>("Paddle", can::Field<&Paddle::y, 0, 16>{"PaddleY", "px"});
+    };
+
+    // Ball and the master's own paddle, sent by the master.
+    struct GameState {
+        int16_t ballX;
+        int16_t ballY;
+        int16_t paddleY;
+
+        static constexpr auto layout = can::layout<6>("GameState",
+                                                      can::Field<&GameState::ballX, 0, 16>{"BallX", "px"},
+                                                      can::Field<&GameState::ballY, 16, 16>{"BallY", "px"},
+                                                      can::Field<&GameState::paddleY, 32, 16>{"PaddleY", "px"});
+    };
+
+    // Sent by both players every 250 ms, and at once when it changes, on masterId with master set or on
+    // notMasterId with it cleared. Lowest TX priority of the three, after the game state and the paddle.
+    struct Role {
+        bool master;
+
+        static constexpr auto layout = can::layout<1>("Role", can::Field<&Role::master, 0, 8>{"Master"});
+    };
+}
+}
+
+#endif // KMK_PONG_CAN_H
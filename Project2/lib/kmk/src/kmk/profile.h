@@ -0,0 +1,137 @@
+#ifndef KMK_PROFILE_H
+#define KMK_PROFILE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+
+namespace kmk
+{
+namespace profile
+{
+    /**
+     * Durations in clock ticks, counted in power-of-two buckets: bucket 0 holds 0, bucket b holds [2^(b-1), 2^b).
+     * Fixed size (33 counters and a few totals), and add() is a count-leading-zeros and two increments.
+    */
+    class Histogram {
+    public:
+        static constexpr uint8_t buckets = 33;
+
+        static constexpr uint8_t bucketOf(uint32_t ticks) {
+            return ticks == 0 ? 0 : static_cast<uint8_t>(32 - __builtin_clz(ticks));
+        }
+
+        // Largest duration that falls in bucket.
+        static constexpr uint32_t upperBound(uint8_t bucket) {
+            return bucket == 0 ? 0 : bucket >= 32 ? ~uint32_t{0} : (uint32_t{1} << bucket) - 1;
+        }
+
+        void add(uint32_t ticks) {
+            ++counts_[bucketOf(ticks)];
+            ++count_;
+            total_ += ticks;
+            last_ = ticks;
+            if (ticks < min_) {
+                min_ = ticks;
+            }
+            if (ticks > max_) {
+                max_ = ticks;
+            }
+        }
+
+        void reset() { *this = Histogram{}; }
+
+        uint32_t count() const { return count_; }
+        uint32_t bucketCount(uint8_t bucket) const { return counts_[bucket]; }
+        uint32_t last() const { return last_; }
+        uint32_t min() const { return count_ > 0 ? min_ : 0; }
+        uint32_t max() const { return max_; }
+        uint32_t mean() const { return count_ > 0 ? static_cast<uint32_t>(total_ / count_) : 0; }
+
+        /**
+         * Upper bound of the bucket holding the given percentile (0-100), never more than max(). At most a
+         * factor two above the true value, which is enough to see where a frame's time goes.
+        */
+        uint32_t percentile(uint8_t percent) const {
+            const uint64_t rank = (static_cast<uint64_t>(count_) * percent + 99) / 100;
+            uint64_t seen = 0;
+            for (uint8_t bucket = 0; bucket < buckets; ++bucket) {
+                seen += counts_[bucket];
+                if (seen >= rank && seen > 0) {
+                    return upperBound(bucket) < max_ ? upperBound(bucket) : max_;
+                }
+            }
+            return max_;
+        }
+
+    private:
+        uint32_t counts_[buckets]{};
+        uint32_t count_{0};
+        uint64_t total_{0};
+        uint32_t last_{0};
+        uint32_t min_{~uint32_t{0}};
+        uint32_t max_{0};
+    };
+
+    /**
+     * Adds the time from construction to destruction to a histogram. Clock is a type with a static
+     * uint32_t now(), such as a cycle counter on the target or a clock the host program advances itself.
+    */
+    template<typename Clock>
+    class Scope {
+    public:
+        explicit Scope(Histogram& histogram) : histogram_(histogram), start_(Clock::now()) {}
+        ~Scope() { histogram_.add(Clock::now() - start_); }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        Histogram& histogram_;
+        uint32_t start_;
+    };
+
+    struct Stage {
+        // Not explicit, so a table of stages reads {"frame"}, {"compose"}, ...
+        Stage(const char* stageName) : name(stageName) {}
+
+        const char* name;
+        Histogram histogram;
+    };
+
+    /**
+     * One line per stage: name, count, min/p50/p90/p99/max/mean, then the non-empty buckets as
+     * <upper bound>:<count>. Times are in ticks / ticksPerUnit, e.g. CPU cycles per microsecond and "us".
+     * Out is anything with print(const char*) and print(unsigned long), like Serial.
+    */
+    template<typename Out>
+    void report(Out& out, const Stage* stages, std::size_t count, uint32_t ticksPerUnit, const char* unit = "us") {
+        auto time = [&](uint32_t ticks) { out.print(static_cast<unsigned long>(ticks / ticksPerUnit)); };
+        out.print("stage n min p50 p90 p99 max mean [");
+        out.print(unit);
+        out.print("]\n");
+        for (std::size_t i = 0; i < count; ++i) {
+            const Histogram& h = stages[i].histogram;
+            out.print(stages[i].name);
+            out.print(" ");
+            out.print(static_cast<unsigned long>(h.count()));
+            for (const uint32_t ticks : {h.min(), h.percentile(50), h.percentile(90), h.percentile(99), h.max(), h.mean()}) {
+                out.print(" ");
+                time(ticks);
+            }
+            out.print(" |");
+            for (uint8_t bucket = 0; bucket < Histogram::buckets; ++bucket) {
+                if (h.bucketCount(bucket) > 0) {
+                    out.print(" ");
+                    time(Histogram::upperBound(bucket));
+                    out.print(":");
+                    out.print(static_cast<unsigned long>(h.bucketCount(bucket)));
+                }
+            }
+            out.print("\n");
+        }
+    }
+}
+}
+
+#endif // KMK_PROFILE_H
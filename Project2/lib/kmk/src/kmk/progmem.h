@@ -0,0 +1,20 @@
+#ifndef KMK_PROGMEM_H
+#define KMK_PROGMEM_H
+
+/**
+ * Lets the same headers be used both in the Teensy build and in the native (host) tools.
+ * On the host there is no separate program memory, so PROGMEM is empty and reads are plain loads.
+ */
+#if defined(ARDUINO)
+#include <avr/pgmspace.h>
+#else
+#include <cstdint>
+#ifndef PROGMEM
+#define PROGMEM
+#endif
+#ifndef pgm_read_byte
+#define pgm_read_byte(addr) (*(const uint8_t*)(addr))
+#endif
+#endif
+
+#endif // KMK_PROGMEM_H
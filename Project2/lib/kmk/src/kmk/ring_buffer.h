@@ -0,0 +1,76 @@
+#ifndef KMK_RING_BUFFER_H
+#define KMK_RING_BUFFER_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace kmk
+{
+    /**
+     * Fixed-size FIFO without allocation. Size must be a power of two; head and tail run freely and are masked,
+     * so all Size slots are usable and size() is a subtraction.
+    */
+    template<typename T, std::size_t Size>
+    class RingBuffer {
+        static_assert(Size > 0 && (Size & (Size - 1)) == 0, "RingBuffer size must be a power of two");
+
+    public:
+        static constexpr std::size_t capacity = Size;
+
+        std::size_t size() const { return head_ - tail_; }
+        std::size_t space() const { return Size - size(); }
+        bool empty() const { return head_ == tail_; }
+
+        bool push(const T& item) {
+            if (space() == 0) {
+                return false;
+            }
+            items_[head_ & mask] = item;
+            ++head_;
+            return true;
+        }
+
+        // All count items or none, so a packet is never split by a full buffer.
+        bool push(const T* items, std::size_t count) {
+            if (space() < count) {
+                return false;
+            }
+            for (std::size_t i = 0; i < count; ++i) {
+                items_[(head_ + i) & mask] = items[i];
+            }
+            head_ += count;
+            return true;
+        }
+
+        bool pop(T& item) {
+            if (empty()) {
+                return false;
+            }
+            item = items_[tail_ & mask];
+            ++tail_;
+            return true;
+        }
+
+        /**
+         * The oldest items that lie in one piece in memory, for handing to a write(ptr, count) call.
+         * Follow with consume() for the number actually taken.
+        */
+        const T* contiguous(std::size_t& count) const {
+            const std::size_t start = tail_ & mask;
+            const std::size_t toEnd = Size - start;
+            count = size() < toEnd ? size() : toEnd;
+            return items_ + start;
+        }
+
+        void consume(std::size_t count) { tail_ += count; }
+
+    private:
+        static constexpr std::size_t mask = Size - 1;
+
+        T items_[Size]{};
+        std::size_t head_{0};
+        std::size_t tail_{0};
+    };
+}
+
+#endif // KMK_RING_BUFFER_H
@@ -0,0 +1,134 @@
+#ifndef KMK_RLE_H
+#define KMK_RLE_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "progmem.h"
+
+namespace kmk
+{
+namespace rle
+{
+    /**
+     * Simple PackBits style run-length coding, tuned for mostly blank 1-bit images.
+     *
+     * Every packet starts with a control byte c:
+     *   c <  0x80: c + 1 literal bytes follow.
+     *   c >= 0x80: the next byte is repeated (c - 0x80 + minRun) times.
+     *
+     * Runs shorter than minRun are cheaper as literals. The encoder is constexpr so it can run
+     * both in the generator and at compile time in the firmware.
+    */
+    constexpr std::size_t minRun = 3;
+    constexpr std::size_t maxRun = 0x7F + minRun;
+    constexpr std::size_t maxLiteral = 0x80;
+
+    template<typename Out>
+    constexpr std::size_t encode(const uint8_t* data, std::size_t size, Out out) {
+        std::size_t written = 0;
+        std::size_t i = 0;
+        std::size_t literalStart = 0;
+
+        auto flushLiterals = [&](std::size_t end) {
+            while (literalStart < end) {
+                std::size_t count = end - literalStart;
+                if (count > maxLiteral) {
+                    count = maxLiteral;
+                }
+                out(static_cast<uint8_t>(count - 1));
+                ++written;
+                for (std::size_t k = 0; k < count; ++k) {
+                    out(data[literalStart + k]);
+                    ++written;
+                }
+                literalStart += count;
+            }
+        };
+
+        while (i < size) {
+            std::size_t run = 1;
+            while (i + run < size && run < maxRun && data[i + run] == data[i]) {
+                ++run;
+            }
+
+            if (run >= minRun) {
+                flushLiterals(i);
+                out(static_cast<uint8_t>(0x80 + run - minRun));
+                out(data[i]);
+                written += 2;
+                i += run;
+                literalStart = i;
+            } else {
+                i += run;
+            }
+        }
+        flushLiterals(size);
+
+        return written;
+    }
+
+    /**
+     * Size of the encoded stream, used to size the output array when encoding at compile time.
+    */
+    constexpr std::size_t encodedSize(const uint8_t* data, std::size_t size) {
+        return encode(data, size, [](uint8_t) {});
+    }
+
+    template<std::size_t N>
+    constexpr std::size_t encodedSize(const std::array<uint8_t, N>& data) {
+        return encodedSize(data.data(), N);
+    }
+
+    /**
+     * Compile-time encoding, size the result with encodedSize() first:
+     *
+     *   constexpr auto packed = kmk::rle::encodeArray<kmk::rle::encodedSize(pixels)>(pixels);
+    */
+    template<std::size_t EncodedSize, std::size_t N>
+    constexpr auto encodeArray(const std::array<uint8_t, N>& data) {
+        std::array<uint8_t, EncodedSize> encoded{};
+        std::size_t index = 0;
+        encode(data.data(), N, [&](uint8_t byte) {
+            if (index < EncodedSize) {
+                encoded[index] = byte;
+            }
+            ++index;
+        });
+        return encoded;
+    }
+
+    /**
+     * Streams the decoded bytes of a (PROGMEM) stream into a sink.
+     *
+     * The sink needs put(byte) for literal bytes and fill(byte, count) for runs, so a sink that
+     * writes straight into a framebuffer can handle long blank runs without a per-byte call.
+     * Returns the number of decoded bytes.
+    */
+    template<typename Sink>
+    std::size_t decode(const uint8_t* src, std::size_t srcSize, Sink&& sink) {
+        std::size_t decoded = 0;
+        std::size_t i = 0;
+
+        while (i < srcSize) {
+            const uint8_t control = pgm_read_byte(src + i++);
+            if (control < 0x80) {
+                const std::size_t count = control + 1u;
+                for (std::size_t k = 0; k < count && i < srcSize; ++k) {
+                    sink.put(pgm_read_byte(src + i++));
+                }
+                decoded += count;
+            } else if (i < srcSize) {
+                const std::size_t count = control - 0x80u + minRun;
+                sink.fill(pgm_read_byte(src + i++), count);
+                decoded += count;
+            }
+        }
+
+        return decoded;
+    }
+}
+}
+
+#endif // KMK_RLE_H
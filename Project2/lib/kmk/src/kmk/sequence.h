@@ -0,0 +1,55 @@
+#ifndef KMK_SEQUENCE_H
+#define KMK_SEQUENCE_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace kmk
+{
+    // One step of a Sequence: action runs, then nothing more happens for holdMillis.
+    template<typename Action>
+    struct TimedStep {
+        Action action;
+        uint32_t holdMillis;
+    };
+
+    /**
+     * Timed list of actions driven from loop() instead of a row of delay() calls. poll() returns at once unless
+     * a step is due, and runs at most one step per call, so whatever else loop() does keeps running in between.
+     * Times are millis() values, compared by subtraction so the 49 day wrap-around does not matter.
+    */
+    template<typename Action>
+    class Sequence {
+    public:
+        template<std::size_t N>
+        constexpr explicit Sequence(const std::array<TimedStep<Action>, N>& steps) : steps_(steps.data()), count_(N) {}
+
+        /**
+         * Calls run(action) for the next step if the previous one has been held long enough.
+         * Returns true if a step was run.
+        */
+        template<typename Run>
+        bool poll(uint32_t now, Run&& run) {
+            if (done() || (next_ > 0 && now - stepStart_ < steps_[next_ - 1].holdMillis)) {
+                return false;
+            }
+            stepStart_ = now;
+            run(steps_[next_++].action);
+            return true;
+        }
+
+        bool done() const { return next_ == count_; }
+
+        // Starts over from the first step at the next poll().
+        void restart() { next_ = 0; }
+
+    private:
+        const TimedStep<Action>* steps_;
+        std::size_t count_;
+        std::size_t next_{0};
+        uint32_t stepStart_{0};
+    };
+}
+
+#endif // KMK_SEQUENCE_H
@@ -0,0 +1,116 @@
+#ifndef KMK_SPRITE_H
+#define KMK_SPRITE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "progmem.h"
+#include "rle.h"
+#include "ssd1306_buffer.h"
+
+namespace kmk
+{
+    /**
+     * One entry in a generated sprite sheet table. The sprite's data starts at offset in the sheet's data array
+     * and holds frameCount + 1 RLE streams of page-major bytes, each prefixed with its length (16 bit, LSB first):
+     * the first frame itself, then the XOR delta from each frame to the next, the last one leading back to the
+     * first frame. A single-frame sprite has an empty delta.
+    */
+    struct SpriteInfo {
+        uint8_t width;
+        uint8_t height;
+        uint16_t offset;
+        uint8_t frameCount;
+    };
+
+namespace ssd1306
+{
+    /**
+     * Decoder sink that XORs page-major bytes into a block of the framebuffer. Zero bytes change nothing,
+     * so runs of them are skipped without touching memory; unchanged parts of a frame cost nothing.
+    */
+    class XorSink {
+    public:
+        XorSink(uint8_t* buffer, std::size_t bufferWidth, std::size_t width, std::size_t x, std::size_t firstPage)
+            : buffer_(buffer + firstPage * bufferWidth + x), bufferWidth_(bufferWidth), width_(width) {}
+
+        void put(uint8_t value) {
+            if (value != 0) {
+                buffer_[(index_ / width_) * bufferWidth_ + index_ % width_] ^= value;
+            }
+            ++index_;
+        }
+
+        void fill(uint8_t value, std::size_t count) {
+            if (value == 0) {
+                index_ += count;
+                return;
+            }
+            for (std::size_t i = 0; i < count; ++i) {
+                put(value);
+            }
+        }
+
+    private:
+        uint8_t* buffer_;
+        std::size_t bufferWidth_;
+        std::size_t width_;
+        std::size_t index_{0};
+    };
+}
+
+    /**
+     * Plays one sprite of a generated sheet into a page-aligned block of the framebuffer.
+     *
+     * reset() clears the block and draws the first frame, next() applies the delta to the following frame
+     * and wraps around after the last one. The player owns the block: anything else drawn there is XORed too.
+    */
+    class AnimationPlayer {
+    public:
+        AnimationPlayer(const uint8_t* sheetData, const SpriteInfo& sprite, int16_t x, uint8_t page)
+            : data_(sheetData + sprite.offset), sprite_(sprite), x_(x), page_(page) {}
+
+        void reset(uint8_t* buffer, int16_t bufferWidth) {
+            const std::size_t pages = (sprite_.height + 7) / 8;
+            for (std::size_t p = 0; p < pages; ++p) {
+                std::memset(buffer + (page_ + p) * bufferWidth + x_, 0, sprite_.width);
+            }
+            frame_ = 0;
+            stream_ = data_;
+            apply(buffer, bufferWidth);  // XOR of the first frame onto a blank block is the first frame.
+        }
+
+        void next(uint8_t* buffer, int16_t bufferWidth) {
+            apply(buffer, bufferWidth);
+            if (++frame_ >= sprite_.frameCount) {
+                frame_ = 0;
+                stream_ = data_ + streamLength(data_);  // Skip the first frame, continue with its delta.
+            }
+        }
+
+        uint8_t frame() const { return frame_; }
+
+    private:
+        static std::size_t streamLength(const uint8_t* stream) {
+            return 2 + (pgm_read_byte(stream) | (pgm_read_byte(stream + 1) << 8));
+        }
+
+        void apply(uint8_t* buffer, int16_t bufferWidth) {
+            const std::size_t length = streamLength(stream_);
+            rle::decode(stream_ + 2, length - 2,
+                        ssd1306::XorSink{buffer, static_cast<std::size_t>(bufferWidth), sprite_.width,
+                                         static_cast<std::size_t>(x_), page_});
+            stream_ += length;
+        }
+
+        const uint8_t* data_;
+        SpriteInfo sprite_;
+        int16_t x_;
+        uint8_t page_;
+        uint8_t frame_{0};
+        const uint8_t* stream_{nullptr};
+    };
+}
+
+#endif // KMK_SPRITE_H
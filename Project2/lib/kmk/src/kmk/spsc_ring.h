@@ -0,0 +1,81 @@
+#ifndef KMK_SPSC_RING_H
+#define KMK_SPSC_RING_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace kmk
+{
+    /**
+     * Lock-free ring for one producer and one consumer that may interrupt each other, such as a receive
+     * interrupt and loop(). Each index is written by one side only; the producer publishes an item by
+     * storing head_ (release) after the item, the consumer frees a slot by storing tail_ after reading it.
+     * On a Cortex-M4 these are plain 32 bit loads and stores, no interrupt masking is needed.
+     *
+     * A push into a full ring is dropped and counted in overflows(); nothing already queued is overwritten.
+    */
+    template<typename T, std::size_t Size>
+    class SpscRing {
+        static_assert(Size > 0 && (Size & (Size - 1)) == 0, "SpscRing size must be a power of two");
+
+    public:
+        static constexpr std::size_t capacity = Size;
+
+        // Producer side.
+        bool push(const T& item) {
+            const uint32_t head = head_.load(std::memory_order_relaxed);
+            if (head - tail_.load(std::memory_order_acquire) == Size) {
+                overflows_.store(overflows_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+                return false;
+            }
+            items_[head & mask] = item;
+            head_.store(head + 1, std::memory_order_release);
+            return true;
+        }
+
+        // Consumer side.
+        bool pop(T& item) {
+            const uint32_t tail = tail_.load(std::memory_order_relaxed);
+            if (tail == head_.load(std::memory_order_acquire)) {
+                return false;
+            }
+            item = items_[tail & mask];
+            tail_.store(tail + 1, std::memory_order_release);
+            return true;
+        }
+
+        /**
+         * Consumer side: hands every queued item to handle(item) and returns how many there were. Only what was
+         * queued when the call started, so a flood of new items cannot keep loop() in here.
+        */
+        template<typename Handle>
+        std::size_t drain(Handle&& handle) {
+            uint32_t tail = tail_.load(std::memory_order_relaxed);
+            const uint32_t head = head_.load(std::memory_order_acquire);
+            const std::size_t count = head - tail;
+            for (; tail != head; ++tail) {
+                handle(static_cast<const T&>(items_[tail & mask]));
+                tail_.store(tail + 1, std::memory_order_release);
+            }
+            return count;
+        }
+
+        std::size_t size() const {
+            return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+        }
+
+        // Items dropped because the ring was full, since start.
+        uint32_t overflows() const { return overflows_.load(std::memory_order_relaxed); }
+
+    private:
+        static constexpr uint32_t mask = Size - 1;
+
+        T items_[Size]{};
+        std::atomic<uint32_t> head_{0};
+        std::atomic<uint32_t> tail_{0};
+        std::atomic<uint32_t> overflows_{0};
+    };
+}
+
+#endif // KMK_SPSC_RING_H
@@ -0,0 +1,102 @@
+#ifndef KMK_SSD1306_BUFFER_H
+#define KMK_SSD1306_BUFFER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace kmk
+{
+namespace ssd1306
+{
+    /**
+     * The SSD1306 (and Adafruit_SSD1306::getBuffer()) stores the screen as pages of 8 rows.
+     * Byte (x + page * width) holds column x of that page, with the top row in the LSB.
+    */
+    constexpr std::size_t pageHeight = 8;
+
+    constexpr std::size_t bufferSize(std::size_t width, std::size_t height) {
+        return width * ((height + pageHeight - 1) / pageHeight);
+    }
+
+    /**
+     * Decoder sink that takes row-major, MSB-first bytes (the Adafruit_GFX::drawBitmap layout that
+     * kmk::compressBinaryArray produces) and writes them into a page-major framebuffer.
+     * The framebuffer must be cleared first, only set bits are written.
+    */
+    class RowMajorSink {
+    public:
+        RowMajorSink(uint8_t* buffer, std::size_t width)
+            : buffer_(buffer), width_(width) {}
+
+        void put(uint8_t value) {
+            if (value != 0) {
+                const std::size_t bit = index_ * 8;
+                const std::size_t x = bit % width_;
+                const std::size_t y = bit / width_;
+                uint8_t* column = buffer_ + (y / pageHeight) * width_ + x;
+                const uint8_t mask = static_cast<uint8_t>(1u << (y % pageHeight));
+                for (std::size_t j = 0; j < 8; ++j) {
+                    if (value & (0x80u >> j)) {
+                        column[j] |= mask;
+                    }
+                }
+            }
+            ++index_;
+        }
+
+        void fill(uint8_t value, std::size_t count) {
+            if (value == 0) {
+                index_ += count;  // Blank runs cost nothing.
+                return;
+            }
+            for (std::size_t i = 0; i < count; ++i) {
+                put(value);
+            }
+        }
+
+    private:
+        uint8_t* buffer_;
+        std::size_t width_;
+        std::size_t index_{0};
+    };
+
+    /**
+     * Decoder sink for page-major data: writes a width x pages block starting at column x and page
+     * firstPage of the framebuffer. A full-width block is just sequential bytes, so runs become memset.
+    */
+    class PageMajorSink {
+    public:
+        PageMajorSink(uint8_t* buffer, std::size_t bufferWidth, std::size_t width,
+                      std::size_t x = 0, std::size_t firstPage = 0)
+            : buffer_(buffer + firstPage * bufferWidth + x), bufferWidth_(bufferWidth), width_(width) {}
+
+        void put(uint8_t value) {
+            buffer_[offset(index_++)] = value;
+        }
+
+        void fill(uint8_t value, std::size_t count) {
+            if (width_ == bufferWidth_) {
+                std::memset(buffer_ + index_, value, count);
+                index_ += count;
+                return;
+            }
+            for (std::size_t i = 0; i < count; ++i) {
+                put(value);
+            }
+        }
+
+    private:
+        std::size_t offset(std::size_t index) const {
+            return (index / width_) * bufferWidth_ + index % width_;
+        }
+
+        uint8_t* buffer_;
+        std::size_t bufferWidth_;
+        std::size_t width_;
+        std::size_t index_{0};
+    };
+}
+}
+
+#endif // KMK_SSD1306_BUFFER_H
@@ -0,0 +1,200 @@
+#ifndef KMK_SSD1306_FLUSH_H
+#define KMK_SSD1306_FLUSH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace kmk
+{
+namespace ssd1306
+{
+    // SSD1306 commands used to send part of the framebuffer (horizontal addressing mode, as set by Adafruit_SSD1306::begin()).
+    constexpr uint8_t columnAddress = 0x21;
+    constexpr uint8_t pageAddress = 0x22;
+
+    /**
+     * Sends only what changed since the last frame. A shadow copy of what the panel shows is compared page by page,
+     * and for each page with changes one column window (first to last changed column) is sent. A 7x7 ball that
+     * moves touches two pages and ~10 columns, about 40 bytes instead of the 1024 display() always sends.
+     *
+     * Frames can be sent all at once with flush(), or in the background: submit() copies the frame into the
+     * flusher's own buffer and works out what to send, and pump() sends at most maxBytes of it per call, so
+     * loop() can keep servicing CAN between chunks. The drawing buffer is free again as soon as submit()
+     * returns; the copy is what is in flight, and submit() refuses a new frame until it has been sent.
+     *
+     * Link is the transport to the panel, with command(bytes, count) and data(bytes, count). See SpiLink for
+     * the Teensy, and the host emulator for tests.
+    */
+    template<typename Link, int16_t Width = 128, int16_t Height = 64>
+    class DiffFlusher {
+    public:
+        static constexpr int16_t pages = (Height + 7) / 8;
+
+        explicit DiffFlusher(Link& link) : link_(link) {}
+
+        /**
+         * Forces the next frame to be sent whole, e.g. after the panel was reset or written by someone else.
+        */
+        void invalidate() { valid_ = false; }
+
+        /**
+         * Takes a copy of frame (Width * pages bytes, page-major like Adafruit_SSD1306::getBuffer()) to be sent
+         * by pump(). Returns false, and takes nothing, while the previous frame is still being sent.
+        */
+        bool submit(const uint8_t* frame) {
+            if (busy_) {
+                return false;
+            }
+            std::memcpy(front_, frame, sizeof(front_));
+
+            std::size_t queued = 0;
+            for (int16_t page = 0; page < pages; ++page) {
+                const uint8_t* row = front_ + page * Width;
+                const uint8_t* shadowRow = shadow_ + page * Width;
+                Span& span = pending_[page];
+                span = {0, Width - 1};
+                if (valid_) {
+                    while (span.first < Width && row[span.first] == shadowRow[span.first]) {
+                        ++span.first;
+                    }
+                    if (span.first == Width) {
+                        span = {Width, -1};  // Page unchanged.
+                        continue;
+                    }
+                    while (row[span.last] == shadowRow[span.last]) {
+                        --span.last;
+                    }
+                }
+                queued += span.last - span.first + 1;
+            }
+            valid_ = true;
+            page_ = 0;
+            skipSentPages();
+            lastFlushBytes_ = queued;
+            return true;
+        }
+
+        /**
+         * Sends up to maxBytes framebuffer bytes of the submitted frame (plus 6 command bytes per window).
+         * Returns the number of framebuffer bytes sent; busy() is false once everything has been sent.
+        */
+        std::size_t pump(std::size_t maxBytes = Width) {
+            std::size_t sent = 0;
+            while (busy_ && sent < maxBytes) {
+                Span& span = pending_[page_];
+                std::size_t count = span.last - span.first + 1;
+                if (count > maxBytes - sent) {
+                    count = maxBytes - sent;
+                }
+                const std::size_t offset = page_ * Width + span.first;
+                sendWindow(page_, span.first, static_cast<int16_t>(span.first + count - 1), front_ + offset);
+                std::memcpy(shadow_ + offset, front_ + offset, count);
+                span.first = static_cast<int16_t>(span.first + count);
+                sent += count;
+                skipSentPages();
+            }
+            return sent;
+        }
+
+        bool busy() const { return busy_; }
+
+        /**
+         * Sends the changed parts of frame right away, waiting for a frame in flight first.
+         * Returns the number of framebuffer bytes sent.
+        */
+        std::size_t flush(const uint8_t* frame) {
+            while (busy_) {
+                pump(sizeof(front_));
+            }
+            submit(frame);
+            while (busy_) {
+                pump(sizeof(front_));
+            }
+            return lastFlushBytes_;
+        }
+
+        // Framebuffer bytes of the last submitted frame.
+        std::size_t lastFlushBytes() const { return lastFlushBytes_; }
+
+    private:
+        struct Span {
+            int16_t first;
+            int16_t last;
+        };
+
+        void skipSentPages() {
+            while (page_ < pages && pending_[page_].first > pending_[page_].last) {
+                ++page_;
+            }
+            busy_ = page_ < pages;
+        }
+
+        void sendWindow(int16_t page, int16_t first, int16_t last, const uint8_t* bytes) {
+            const uint8_t commands[] = {
+                columnAddress, static_cast<uint8_t>(first), static_cast<uint8_t>(last),
+                pageAddress, static_cast<uint8_t>(page), static_cast<uint8_t>(page),
+            };
+            link_.command(commands, sizeof(commands));
+            link_.data(bytes, static_cast<std::size_t>(last - first + 1));
+        }
+
+        Link& link_;
+        uint8_t shadow_[Width * pages]{};
+        uint8_t front_[Width * pages]{};
+        Span pending_[pages]{};
+        int16_t page_{pages};
+        bool valid_{false};
+        bool busy_{false};
+        std::size_t lastFlushBytes_{0};
+    };
+
+    /**
+     * Several panels on one bus, such as two SSD1306 on the same SPI pins with a chip select each. Every panel
+     * has its own DiffFlusher and so its own shadow: a panel whose frame did not change costs nothing.
+     *
+     * pump() serves the busy flushers in turn, one chunk per call, so no panel waits behind a whole frame of
+     * another and a call still takes no longer than one chunk.
+    */
+    template<typename Flusher, std::size_t N>
+    class FlushScheduler {
+    public:
+        template<typename... Flushers>
+        explicit FlushScheduler(Flushers&... flushers) : flushers_{&flushers...} {
+            static_assert(sizeof...(Flushers) == N, "One flusher per panel");
+        }
+
+        static constexpr std::size_t size() { return N; }
+        Flusher& operator[](std::size_t panel) { return *flushers_[panel]; }
+
+        /**
+         * Sends up to maxBytes for the next panel with something to send. Returns the framebuffer bytes sent.
+        */
+        std::size_t pump(std::size_t maxBytes) {
+            for (std::size_t i = 0; i < N; ++i) {
+                Flusher& flusher = *flushers_[next_];
+                next_ = (next_ + 1) % N;
+                if (flusher.busy()) {
+                    return flusher.pump(maxBytes);
+                }
+            }
+            return 0;
+        }
+
+        bool busy() const {
+            for (const Flusher* flusher : flushers_) {
+                if (flusher->busy()) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+    private:
+        Flusher* flushers_[N];
+        std::size_t next_{0};
+    };
+}
+}
+
+#endif // KMK_SSD1306_FLUSH_H
@@ -0,0 +1,43 @@
+#ifndef KMK_SSD1306_SPI_H
+#define KMK_SSD1306_SPI_H
+
+#include <Arduino.h>
+#include <SPI.h>
+
+namespace kmk
+{
+namespace ssd1306
+{
+    /**
+     * Raw SPI transport to an SSD1306, for DiffFlusher. Uses the same pins and clock as the Adafruit_SSD1306 object
+     * that initialized the panel (call display.begin() first, it sets up the pins and SPI).
+    */
+    class SpiLink {
+    public:
+        SpiLink(SPIClass& spi, uint8_t dcPin, uint8_t csPin, uint32_t clockHz = 8000000UL)
+            : spi_(spi), settings_(clockHz, MSBFIRST, SPI_MODE0), dcPin_(dcPin), csPin_(csPin) {}
+
+        void command(const uint8_t* bytes, size_t count) { transfer(LOW, bytes, count); }
+        void data(const uint8_t* bytes, size_t count) { transfer(HIGH, bytes, count); }
+
+    private:
+        void transfer(uint8_t dc, const uint8_t* bytes, size_t count) {
+            spi_.beginTransaction(settings_);
+            digitalWrite(dcPin_, dc);
+            digitalWrite(csPin_, LOW);
+            for (size_t i = 0; i < count; ++i) {
+                spi_.transfer(bytes[i]);
+            }
+            digitalWrite(csPin_, HIGH);
+            spi_.endTransaction();
+        }
+
+        SPIClass& spi_;
+        SPISettings settings_;
+        uint8_t dcPin_;
+        uint8_t csPin_;
+    };
+}
+}
+
+#endif // KMK_SSD1306_SPI_H
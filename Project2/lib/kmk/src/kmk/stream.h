@@ -0,0 +1,191 @@
+#ifndef KMK_STREAM_H
+#define KMK_STREAM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "packet.h"
+#include "rle.h"
+
+namespace kmk
+{
+namespace stream
+{
+    /**
+     * Framebuffer streaming protocol, used over the USB serial port to watch the OLED on a PC. Packets are framed
+     * as in kmk/packet.h:
+     *   Span:     page, first column, column count - 1, RLE (kmk::rle) of the page bytes of those columns.
+     *   FrameEnd: frame number, 16 bit LSB first. Everything received before it makes up that frame.
+    */
+    enum class PacketType : uint8_t {
+        Span = 'S',
+        FrameEnd = 'E',
+    };
+
+    // Worst case RLE of a full 128 column page is 129 bytes, so any span fits the one byte length.
+    constexpr std::size_t maxPayload = 3 + 128 + 128 / rle::maxLiteral + 1;
+    static_assert(maxPayload <= packet::maxPayload, "A span must fit in one packet");
+
+    /**
+     * Sends the parts of each frame that changed since the last one, RLE-compressed, through a
+     * kmk::packet::Channel, so the port is never waited for; pump the channel from loop().
+     *
+     * A span that does not fit in the channel is not queued and its columns are not marked as sent, so it goes out
+     * with a later frame; the viewer may skip frames under load but never ends up with a wrong picture.
+    */
+    template<typename Channel, int16_t Width = 128, int16_t Height = 64>
+    class FrameStreamer {
+    public:
+        static constexpr int16_t pages = (Height + 7) / 8;
+
+        explicit FrameStreamer(Channel& channel) : channel_(channel) {}
+
+        /**
+         * Queues the changes in frame (page-major, Width * pages bytes) and a frame end.
+         * Returns false if some of it had to be left for a later frame.
+        */
+        bool submit(const uint8_t* frame) {
+            bool complete = true;
+            for (int16_t page = 0; page < pages; ++page) {
+                const uint8_t* row = frame + page * Width;
+                uint8_t* shadowRow = shadow_ + page * Width;
+                int16_t first = 0;
+                int16_t last = Width - 1;
+                if (pageSent_[page]) {
+                    while (first < Width && row[first] == shadowRow[first]) {
+                        ++first;
+                    }
+                    if (first == Width) {
+                        continue;
+                    }
+                    while (row[last] == shadowRow[last]) {
+                        --last;
+                    }
+                }
+                // Whatever is not queued stays different from the shadow and is retried with the next frame.
+                // Until a page has gone out whole once the shadow says nothing about it, so it is sent whole.
+                if (queueSpan(page, first, last, row)) {
+                    std::memcpy(shadowRow + first, row + first, last - first + 1);
+                    pageSent_[page] = true;
+                } else {
+                    complete = false;
+                    ++droppedSpans_;
+                }
+            }
+
+            const uint8_t number[] = {static_cast<uint8_t>(frameNumber_), static_cast<uint8_t>(frameNumber_ >> 8)};
+            if (channel_.send(static_cast<uint8_t>(PacketType::FrameEnd), number, sizeof(number))) {
+                ++frameNumber_;
+            } else {
+                complete = false;
+            }
+            return complete;
+        }
+
+        // Resends everything with the next frame, e.g. when a viewer connects.
+        void invalidate() {
+            for (bool& sent : pageSent_) {
+                sent = false;
+            }
+        }
+
+        std::size_t droppedSpans() const { return droppedSpans_; }
+
+    private:
+        bool queueSpan(int16_t page, int16_t first, int16_t last, const uint8_t* row) {
+            uint8_t payload[maxPayload];
+            payload[0] = static_cast<uint8_t>(page);
+            payload[1] = static_cast<uint8_t>(first);
+            payload[2] = static_cast<uint8_t>(last - first);
+            std::size_t size = 3;
+            rle::encode(row + first, static_cast<std::size_t>(last - first + 1), [&](uint8_t byte) {
+                payload[size++] = byte;
+            });
+            return channel_.send(static_cast<uint8_t>(PacketType::Span), payload, size);
+        }
+
+        Channel& channel_;
+        uint8_t shadow_[Width * pages]{};
+        bool pageSent_[pages]{};
+        uint16_t frameNumber_{0};
+        std::size_t droppedSpans_{0};
+    };
+
+    /**
+     * Receiving end: rebuilds the framebuffer from the packets. Either feed() it bytes, or, when the port carries
+     * other packets too, run a kmk::packet::Parser and apply() the packets it completes.
+    */
+    template<int16_t Width = 128, int16_t Height = 64>
+    class FrameDecoder {
+    public:
+        static constexpr int16_t pages = (Height + 7) / 8;
+
+        /**
+         * Returns true when byte completed a frame; frame() and frameNumber() then describe it.
+        */
+        bool feed(uint8_t byte) {
+            return parser_.feed(byte) == packet::Parser::Result::Packet
+                   && apply(parser_.type(), parser_.payload(), parser_.length());
+        }
+
+        /**
+         * Applies one whole packet. Returns true when it completed a frame. Packets of other types are errors.
+        */
+        bool apply(uint8_t type, const uint8_t* payload, std::size_t length) {
+            if (type == static_cast<uint8_t>(PacketType::FrameEnd) && length == 2) {
+                frameNumber_ = static_cast<uint16_t>(payload[0] | (payload[1] << 8));
+                return true;
+            }
+            if (type == static_cast<uint8_t>(PacketType::Span) && length >= 3) {
+                const uint8_t page = payload[0];
+                const uint8_t first = payload[1];
+                const std::size_t count = payload[2] + 1u;
+                uint8_t columns[Width];
+                SpanSink sink{columns, sizeof(columns)};
+                rle::decode(payload + 3, length - 3u, sink);
+                if (page >= pages || first + count > static_cast<std::size_t>(Width) || sink.size != count) {
+                    ++errors_;
+                    return false;
+                }
+                std::memcpy(frame_ + page * Width + first, columns, count);
+                return false;
+            }
+            ++errors_;
+            return false;
+        }
+
+        const uint8_t* frame() const { return frame_; }
+        uint16_t frameNumber() const { return frameNumber_; }
+        // Bad packets: checksum errors seen by feed() and packets that made no sense.
+        std::size_t errors() const { return errors_ + parser_.errors(); }
+
+    private:
+        // Collects one span's decoded bytes, refusing to write past the span.
+        struct SpanSink {
+            uint8_t* out;
+            std::size_t capacity;
+            std::size_t size{0};
+
+            void put(uint8_t value) {
+                if (size < capacity) {
+                    out[size] = value;
+                }
+                ++size;
+            }
+            void fill(uint8_t value, std::size_t count) {
+                for (std::size_t i = 0; i < count; ++i) {
+                    put(value);
+                }
+            }
+        };
+
+        packet::Parser parser_;
+        uint8_t frame_[Width * pages]{};
+        uint16_t frameNumber_{0};
+        std::size_t errors_{0};
+    };
+}
+}
+
+#endif // KMK_STREAM_H
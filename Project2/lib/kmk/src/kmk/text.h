@@ -0,0 +1,127 @@
+#ifndef KMK_TEXT_H
+#define KMK_TEXT_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "blit.h"
+#include "progmem.h"
+
+namespace kmk
+{
+    /**
+     * Metrics of one glyph in a generated font atlas: where its columns start and how many there are.
+    */
+    struct Glyph {
+        uint16_t offset;
+        uint8_t width;
+    };
+
+    /**
+     * Page-aligned font atlas from the generator. Every glyph is width x (pages * 8) page-major bytes, so drawing
+     * a character is one byte per column and page instead of one drawPixel per lit pixel.
+    */
+    struct Font {
+        const uint8_t* columns;
+        const Glyph* glyphs;
+        uint8_t first;
+        uint8_t count;
+        uint8_t pages;
+        uint8_t spacing;  // Blank columns between glyphs.
+        uint8_t lineHeight;
+
+        constexpr const Glyph* glyph(char c) const {
+            const uint8_t index = static_cast<uint8_t>(c) - first;
+            return index < count ? &glyphs[index] : nullptr;
+        }
+    };
+
+    /**
+     * Width in pixels of text drawn with font, usable at compile time.
+    */
+    constexpr int16_t textWidth(const Font& font, const char* text) {
+        int16_t width = 0;
+        for (; *text != '\0'; ++text) {
+            if (const Glyph* g = font.glyph(*text)) {
+                width = static_cast<int16_t>(width + g->width + font.spacing);
+            }
+        }
+        return width > 0 ? static_cast<int16_t>(width - font.spacing) : 0;
+    }
+
+    /**
+     * Draws text with its top left corner at (x, y) and returns the x after the last glyph. Page-aligned y copies the
+     * glyph columns straight in, other y values shift them across two pages. Characters missing from the font are skipped.
+    */
+    inline int16_t drawText(uint8_t* buffer, int16_t bufferWidth, int16_t bufferHeight, const Font& font,
+                            int16_t x, int16_t y, const char* text, ssd1306::BlitMode mode = ssd1306::BlitMode::Or) {
+        for (; *text != '\0' && x < bufferWidth; ++text) {
+            if (const Glyph* g = font.glyph(*text)) {
+                // Glyph columns are stored glyph by glyph, each glyph its own page-major block.
+                ssd1306::blitPageMajor(buffer, bufferWidth, bufferHeight, x, y, font.columns + g->offset,
+                                       g->width, static_cast<int16_t>(font.pages * 8), mode);
+                x = static_cast<int16_t>(x + g->width + font.spacing);
+            }
+        }
+        return x;
+    }
+
+    /**
+     * Text rendered at compile time into one page-major block, so a constant label is a single blit at run time.
+     * Use KMK_PRERENDER(font, "Label") to get the size right.
+    */
+    template<int16_t Width, uint8_t Pages>
+    struct PrerenderedText {
+        std::array<uint8_t, Width * Pages> columns;
+
+        static constexpr int16_t width = Width;
+        static constexpr int16_t height = Pages * 8;
+
+        void draw(uint8_t* buffer, int16_t bufferWidth, int16_t bufferHeight, int16_t x, int16_t y,
+                  ssd1306::BlitMode mode = ssd1306::BlitMode::Or) const {
+            ssd1306::blitPageMajor(buffer, bufferWidth, bufferHeight, x, y, columns.data(), Width, height, mode);
+        }
+    };
+
+    template<int16_t Width, uint8_t Pages>
+    constexpr PrerenderedText<Width, Pages> prerender(const Font& font, const char* text) {
+        PrerenderedText<Width, Pages> result{};
+        int16_t x = 0;
+        for (; *text != '\0'; ++text) {
+            if (const Glyph* g = font.glyph(*text)) {
+                for (uint8_t page = 0; page < Pages; ++page) {
+                    for (uint8_t column = 0; column < g->width; ++column) {
+                        result.columns[page * Width + x + column] = font.columns[g->offset + page * g->width + column];
+                    }
+                }
+                x = static_cast<int16_t>(x + g->width + font.spacing);
+            }
+        }
+        return result;
+    }
+
+#define KMK_PRERENDER(font, text) (::kmk::prerender<::kmk::textWidth((font), (text)), (font).pages>((font), (text)))
+
+    /**
+     * Unsigned integer to text without going through Print. out needs room for 11 characters (10 digits and '\0')
+     * in base 10, 9 in base 16. Returns the number of characters written, without the terminator.
+    */
+    inline uint8_t formatUnsigned(char* out, uint32_t value, uint8_t base = 10) {
+        char digits[10];
+        uint8_t count = 0;
+        do {
+            const uint8_t digit = static_cast<uint8_t>(value % base);
+            digits[count++] = static_cast<char>(digit < 10 ? '0' + digit : 'A' + digit - 10);
+            value /= base;
+        } while (value != 0);
+
+        for (uint8_t i = 0; i < count; ++i) {
+            out[i] = digits[count - 1 - i];
+        }
+        out[count] = '\0';
+        return count;
+    }
+}
+
+#endif // KMK_TEXT_H
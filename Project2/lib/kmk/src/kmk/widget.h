@@ -0,0 +1,139 @@
+#ifndef KMK_WIDGET_H
+#define KMK_WIDGET_H
+
+#include <cstdint>
+#include <cstring>
+
+#include "text.h"
+
+namespace kmk
+{
+    struct Rect {
+        int16_t x;
+        int16_t y;
+        int16_t w;
+        int16_t h;
+
+        constexpr bool empty() const { return w <= 0 || h <= 0; }
+    };
+
+    /**
+     * Retained "Label: text" field on a fixed line of the screen. The label is drawn once into the background,
+     * the text only when it changes, and then only from the first character that differs: a counter going from
+     * 1234 to 1235 redraws one glyph.
+     *
+     * Background is anything with restore(buffer, x, y, w, h) that puts the background back over an area,
+     * such as ssd1306::Compositor.
+    */
+    class TextField {
+    public:
+        static constexpr uint8_t maxLength = 20;  // Longer texts are cut, 21 glyphs fill the screen anyway.
+
+        constexpr TextField(const Font& font, const char* label, int16_t x, int16_t y, int16_t right)
+            : font_(font), label_(label), x_(x), y_(y),
+              valueX_(static_cast<int16_t>(x + textWidth(font, label) + 1)), right_(right) {}
+
+        /**
+         * Draws the label, normally into the display buffer before it is captured as background.
+        */
+        template<typename Display>
+        void drawLabel(Display& display) const {
+            drawText(display.getBuffer(), display.width(), display.height(), font_, x_, y_, label_);
+        }
+
+        /**
+         * Shows text, redrawing only what changed. Returns the area that was redrawn, empty when the text is
+         * unchanged; whoever sends the frame can use it as the dirty region.
+        */
+        template<typename Display, typename Background>
+        Rect update(Display& display, const Background& background, const char* text) {
+            char shown[maxLength + 1];
+            std::strncpy(shown, text, maxLength);
+            shown[maxLength] = '\0';
+            if (valid_ && std::strcmp(shown, shown_) == 0) {
+                return {valueX_, y_, 0, 0};
+            }
+
+            uint8_t first = 0;
+            int16_t x = valueX_;
+            if (valid_) {
+                // Glyphs before the first changed character keep their place, even in a proportional font.
+                for (; shown[first] != '\0' && shown[first] == shown_[first]; ++first) {
+                    if (const Glyph* g = font_.glyph(shown[first])) {
+                        x = static_cast<int16_t>(x + g->width + font_.spacing);
+                    }
+                }
+            }
+
+            // Only the old text needs erasing, the field's full width only when nothing is known about it.
+            const int16_t height = static_cast<int16_t>(font_.pages * 8);
+            const int16_t oldEnd = valid_ ? end_ : right_;
+            background.restore(display.getBuffer(), x, y_, static_cast<int16_t>(oldEnd - x), height);
+            end_ = drawText(display.getBuffer(), display.width(), display.height(), font_, x, y_, shown + first);
+            if (end_ > right_) {
+                end_ = right_;
+            }
+
+            std::memcpy(shown_, shown, sizeof(shown_));
+            valid_ = true;
+            return {x, y_, static_cast<int16_t>((oldEnd > end_ ? oldEnd : end_) - x), height};
+        }
+
+        // Redraw the whole text at the next update(), e.g. after the background was redrawn.
+        void invalidate() { valid_ = false; }
+
+    private:
+        const Font& font_;
+        const char* label_;
+        int16_t x_;
+        int16_t y_;
+        int16_t valueX_;
+        int16_t right_;
+
+        int16_t end_{0};  // x after the last glyph shown.
+        bool valid_{false};
+        char shown_[maxLength + 1]{};
+    };
+
+    /**
+     * TextField bound to a number, formatted with formatUnsigned() in base 10 or 16. An unchanged value
+     * costs one compare.
+    */
+    class NumberField {
+    public:
+        constexpr NumberField(const Font& font, const char* label, int16_t x, int16_t y, int16_t right, uint8_t base = 10)
+            : field_(font, label, x, y, right), base_(base) {}
+
+        template<typename Display>
+        void drawLabel(Display& display) const {
+            field_.drawLabel(display);
+        }
+
+        template<typename Display, typename Background>
+        Rect update(Display& display, const Background& background, uint32_t value) {
+            if (valid_ && value == value_) {
+                return {0, 0, 0, 0};
+            }
+            char text[maxDigits + 1];
+            formatUnsigned(text, value, base_);
+            value_ = value;
+            valid_ = true;
+            return field_.update(display, background, text);
+        }
+
+        void invalidate() {
+            valid_ = false;
+            field_.invalidate();
+        }
+
+    private:
+        static constexpr uint8_t maxDigits = 10;  // uint32_t in base 10.
+
+        TextField field_;
+        uint8_t base_;
+        uint32_t value_{0};
+        bool valid_{false};
+    };
+}
+
+#endif // KMK_WIDGET_H
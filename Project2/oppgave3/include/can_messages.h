@@ -0,0 +1,24 @@
+#ifndef CAN_MESSAGES_H
+#define CAN_MESSAGES_H
+
+// The CAN messages main.cpp sends, declared once with kmk/can_schema.h; src/can_dbc.cpp exports them for PCAN-View.
+
+#include <cstdint>
+
+#include <kmk/can_schema.h>
+
+namespace messages {
+  // Position of the circle, sent after every animation step.
+  struct Coordinates {
+    static constexpr uint32_t id = 0x245;
+
+    int16_t x;
+    int16_t y;
+
+    static constexpr auto layout = kmk::can::layout<4>("Coordinates",
+                                                       kmk::can::Field<&Coordinates::x, 0, 16>{"X", "px"},
+                                                       kmk::can::Field<&Coordinates::y, 16, 16>{"Y", "px"});
+  };
+}
+
+#endif // CAN_MESSAGES_H
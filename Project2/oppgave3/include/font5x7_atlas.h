@@ -0,0 +1,146 @@
+// kmk-asset-hash: e4ebc7da3e506692
+// Generated by src/generator.cpp from res/font5x7.pbm, do not edit.
+#ifndef FONT5X7_ATLAS_H
+#define FONT5X7_ATLAS_H
+
+#include <kmk/text.h>
+
+namespace fonts {
+    namespace font5x7 {
+        // Page-major glyph columns, 1 page(s) per glyph.
+        static constexpr uint8_t PROGMEM columns[] = {
+            0x00, 0x00, 0x00, 0x5f, 0x07, 0x00, 0x07, 0x14, 0x7f, 0x14, 0x7f, 0x14, 0x24, 0x2a, 0x7f, 0x2a,
+            0x12, 0x23, 0x13, 0x08, 0x64, 0x62, 0x36, 0x49, 0x56, 0x20, 0x50, 0x08, 0x07, 0x03, 0x1c, 0x22,
+            0x41, 0x41, 0x22, 0x1c, 0x2a, 0x1c, 0x7f, 0x1c, 0x2a, 0x08, 0x08, 0x3e, 0x08, 0x08, 0x80, 0x70,
+            0x30, 0x08, 0x08, 0x08, 0x08, 0x08, 0x60, 0x60, 0x20, 0x10, 0x08, 0x04, 0x02, 0x3e, 0x51, 0x49,
+            0x45, 0x3e, 0x42, 0x7f, 0x40, 0x72, 0x49, 0x49, 0x49, 0x46, 0x21, 0x41, 0x49, 0x4d, 0x33, 0x18,
+            0x14, 0x12, 0x7f, 0x10, 0x27, 0x45, 0x45, 0x45, 0x39, 0x3c, 0x4a, 0x49, 0x49, 0x31, 0x41, 0x21,
+            0x11, 0x09, 0x07, 0x36, 0x49, 0x49, 0x49, 0x36, 0x46, 0x49, 0x49, 0x29, 0x1e, 0x14, 0x40, 0x34,
+            0x08, 0x14, 0x22, 0x41, 0x14, 0x14, 0x14, 0x14, 0x14, 0x41, 0x22, 0x14, 0x08, 0x02, 0x01, 0x59,
+            0x09, 0x06, 0x3e, 0x41, 0x5d, 0x59, 0x4e, 0x7c, 0x12, 0x11, 0x12, 0x7c, 0x7f, 0x49, 0x49, 0x49,
+            0x36, 0x3e, 0x41, 0x41, 0x41, 0x22, 0x7f, 0x41, 0x41, 0x41, 0x3e, 0x7f, 0x49, 0x49, 0x49, 0x41,
+            0x7f, 0x09, 0x09, 0x09, 0x01, 0x3e, 0x41, 0x41, 0x51, 0x73, 0x7f, 0x08, 0x08, 0x08, 0x7f, 0x41,
+            0x7f, 0x41, 0x20, 0x40, 0x41, 0x3f, 0x01, 0x7f, 0x08, 0x14, 0x22, 0x41, 0x7f, 0x40, 0x40, 0x40,
+            0x40, 0x7f, 0x02, 0x1c, 0x02, 0x7f, 0x7f, 0x04, 0x08, 0x10, 0x7f, 0x3e, 0x41, 0x41, 0x41, 0x3e,
+            0x7f, 0x09, 0x09, 0x09, 0x06, 0x3e, 0x41, 0x51, 0x21, 0x5e, 0x7f, 0x09, 0x19, 0x29, 0x46, 0x26,
+            0x49, 0x49, 0x49, 0x32, 0x03, 0x01, 0x7f, 0x01, 0x03, 0x3f, 0x40, 0x40, 0x40, 0x3f, 0x1f, 0x20,
+            0x40, 0x20, 0x1f, 0x3f, 0x40, 0x38, 0x40, 0x3f, 0x63, 0x14, 0x08, 0x14, 0x63, 0x03, 0x04, 0x78,
+            0x04, 0x03, 0x61, 0x59, 0x49, 0x4d, 0x43, 0x7f, 0x41, 0x41, 0x41, 0x02, 0x04, 0x08, 0x10, 0x20,
+            0x41, 0x41, 0x41, 0x7f, 0x04, 0x02, 0x01, 0x02, 0x04, 0x40, 0x40, 0x40, 0x40, 0x40, 0x03, 0x07,
+            0x08, 0x20, 0x54, 0x54, 0x78, 0x40, 0x7f, 0x28, 0x44, 0x44, 0x38, 0x38, 0x44, 0x44, 0x44, 0x28,
+            0x38, 0x44, 0x44, 0x28, 0x7f, 0x38, 0x54, 0x54, 0x54, 0x18, 0x08, 0x7e, 0x09, 0x02, 0x18, 0xa4,
+            0xa4, 0x9c, 0x78, 0x7f, 0x08, 0x04, 0x04, 0x78, 0x44, 0x7d, 0x40, 0x20, 0x40, 0x40, 0x3d, 0x7f,
+            0x10, 0x28, 0x44, 0x41, 0x7f, 0x40, 0x7c, 0x04, 0x78, 0x04, 0x78, 0x7c, 0x08, 0x04, 0x04, 0x78,
+            0x38, 0x44, 0x44, 0x44, 0x38, 0xfc, 0x18, 0x24, 0x24, 0x18, 0x18, 0x24, 0x24, 0x18, 0xfc, 0x7c,
+            0x08, 0x04, 0x04, 0x08, 0x48, 0x54, 0x54, 0x54, 0x24, 0x04, 0x04, 0x3f, 0x44, 0x24, 0x3c, 0x40,
+            0x40, 0x20, 0x7c, 0x1c, 0x20, 0x40, 0x20, 0x1c, 0x3c, 0x40, 0x30, 0x40, 0x3c, 0x44, 0x28, 0x10,
+            0x28, 0x44, 0x4c, 0x90, 0x90, 0x90, 0x7c, 0x44, 0x64, 0x54, 0x4c, 0x44, 0x08, 0x36, 0x41, 0x77,
+            0x41, 0x36, 0x08, 0x02, 0x01, 0x02, 0x04, 0x02, 0x00, 0x00, 0x00,
+        };
+
+        // Offset into columns and width of every glyph.
+        constexpr kmk::Glyph glyphs[] = {
+            {0, 3},  // ' '
+            {3, 1},  // '!'
+            {4, 3},  // '"'
+            {7, 5},  // '#'
+            {12, 5},  // '$'
+            {17, 5},  // '%'
+            {22, 5},  // '&'
+            {27, 3},  // '''
+            {30, 3},  // '('
+            {33, 3},  // ')'
+            {36, 5},  // '*'
+            {41, 5},  // '+'
+            {46, 3},  // ','
+            {49, 5},  // '-'
+            {54, 2},  // '.'
+            {56, 5},  // '/'
+            {61, 5},  // '0'
+            {66, 3},  // '1'
+            {69, 5},  // '2'
+            {74, 5},  // '3'
+            {79, 5},  // '4'
+            {84, 5},  // '5'
+            {89, 5},  // '6'
+            {94, 5},  // '7'
+            {99, 5},  // '8'
+            {104, 5},  // '9'
+            {109, 1},  // ':'
+            {110, 2},  // ';'
+            {112, 4},  // '<'
+            {116, 5},  // '='
+            {121, 4},  // '>'
+            {125, 5},  // '?'
+            {130, 5},  // '@'
+            {135, 5},  // 'A'
+            {140, 5},  // 'B'
+            {145, 5},  // 'C'
+            {150, 5},  // 'D'
+            {155, 5},  // 'E'
+            {160, 5},  // 'F'
+            {165, 5},  // 'G'
+            {170, 5},  // 'H'
+            {175, 3},  // 'I'
+            {178, 5},  // 'J'
+            {183, 5},  // 'K'
+            {188, 5},  // 'L'
+            {193, 5},  // 'M'
+            {198, 5},  // 'N'
+            {203, 5},  // 'O'
+            {208, 5},  // 'P'
+            {213, 5},  // 'Q'
+            {218, 5},  // 'R'
+            {223, 5},  // 'S'
+            {228, 5},  // 'T'
+            {233, 5},  // 'U'
+            {238, 5},  // 'V'
+            {243, 5},  // 'W'
+            {248, 5},  // 'X'
+            {253, 5},  // 'Y'
+            {258, 5},  // 'Z'
+            {263, 4},  // '['
+            {267, 5},  // '\\'
+            {272, 4},  // ']'
+            {276, 5},  // '^'
+            {281, 5},  // '_'
+            {286, 3},  // '`'
+            {289, 5},  // 'a'
+            {294, 5},  // 'b'
+            {299, 5},  // 'c'
+            {304, 5},  // 'd'
+            {309, 5},  // 'e'
+            {314, 4},  // 'f'
+            {318, 5},  // 'g'
+            {323, 5},  // 'h'
+            {328, 3},  // 'i'
+            {331, 4},  // 'j'
+            {335, 4},  // 'k'
+            {339, 3},  // 'l'
+            {342, 5},  // 'm'
+            {347, 5},  // 'n'
+            {352, 5},  // 'o'
+            {357, 5},  // 'p'
+            {362, 5},  // 'q'
+            {367, 5},  // 'r'
+            {372, 5},  // 's'
+            {377, 5},  // 't'
+            {382, 5},  // 'u'
+            {387, 5},  // 'v'
+            {392, 5},  // 'w'
+            {397, 5},  // 'x'
+            {402, 5},  // 'y'
+            {407, 5},  // 'z'
+            {412, 3},  // '{'
+            {415, 1},  // '|'
+            {416, 3},  // '}'
+            {419, 5},  // '~'
+            {424, 3},
+        };
+
+        constexpr kmk::Font font{columns, glyphs, 32, 96, 1, 1, 8};
+    };
+
+};
+
+#endif // FONT5X7_ATLAS_H
@@ -0,0 +1,24 @@
+#ifndef LOG_MESSAGES_H
+#define LOG_MESSAGES_H
+
+// Format strings for the binary log records (kmk/log.h). main.cpp sends a message's number and its arguments,
+// src/frame_viewer.cpp prints the text. Only append: the numbers of recorded captures must keep their meaning.
+
+#include <cstdint>
+
+namespace logs {
+  enum Message : uint8_t {
+    FloatSize,
+    CanSent,
+    CanSendFailed,
+    Count,
+  };
+
+  constexpr const char* formats[Count] = {
+    "float size in bytes: %u",
+    "Sent Coordinates - X: %d, Y: %d",
+    "CAN send failed. X: %d, Y: %d",
+  };
+}
+
+#endif // LOG_MESSAGES_H
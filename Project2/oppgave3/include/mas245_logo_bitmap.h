@@ -1,1042 +0,0 @@
-#ifndef MAS245_LOGO_BITMAP_H
-#define MAS245_LOGO_BITMAP_H
-
-#include <avr/pgmspace.h>
-
-namespace images {
-    namespace mas245splash {
-        constexpr uint8_t width{128};
-
-        constexpr uint8_t height{64};
-        static const uint8_t PROGMEM bitmap[] = {
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00001000,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00001000,
-            0b00000000,
-            0b00000010,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00011000,
-            0b00000000,
-            0b00000111,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00111100,
-            0b00000100,
-            0b00001111,
-            0b00000000,
-            0b00000001,
-            0b11000000,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00001111,
-            0b10000000,
-            0b10010000,
-            0b10000110,
-            0b00010000,
-            0b01100010,
-            0b00000000,
-            0b01110000,
-            0b00000100,
-            0b00000010,
-            0b00000100,
-            0b01000000,
-            0b00000000,
-            0b01000000,
-            0b00000000,
-            0b00110000,
-            0b01100000,
-            0b01100000,
-            0b00000000,
-            0b00000110,
-            0b00010000,
-            0b00100010,
-            0b00000000,
-            0b01101000,
-            0b00001110,
-            0b00000000,
-            0b00000000,
-            0b01000110,
-            0b00011000,
-            0b00000000,
-            0b00000001,
-            0b10000000,
-            0b01000110,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00010000,
-            0b00001000,
-            0b00000000,
-            0b01111000,
-            0b00000100,
-            0b00000011,
-            0b00010000,
-            0b00000000,
-            0b01000000,
-            0b00000000,
-            0b00000001,
-            0b00000010,
-            0b10001111,
-            0b00000000,
-            0b11100000,
-            0b10110000,
-            0b01111110,
-            0b00001000,
-            0b00000001,
-            0b01111100,
-            0b01000000,
-            0b00000111,
-            0b10000000,
-            0b00000000,
-            0b01000001,
-            0b11100000,
-            0b01000000,
-            0b00000000,
-            0b10011111,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b11111110,
-            0b00000000,
-            0b00000000,
-            0b01010100,
-            0b00000000,
-            0b00010111,
-            0b00000000,
-            0b01000000,
-            0b00001000,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b01111110,
-            0b00001001,
-            0b11111001,
-            0b00000000,
-            0b00000000,
-            0b01010000,
-            0b00000000,
-            0b00001111,
-            0b10010000,
-            0b01000000,
-            0b01000000,
-            0b00001100,
-            0b00000000,
-            0b00000000,
-            0b01000000,
-            0b00000001,
-            0b11111011,
-            0b00000000,
-            0b11111000,
-            0b00000000,
-            0b10000000,
-            0b11010000,
-            0b00000000,
-            0b00001111,
-            0b11000000,
-            0b01000000,
-            0b11100000,
-            0b00111110,
-            0b00001001,
-            0b00000010,
-            0b00110110,
-            0b11000011,
-            0b11111110,
-            0b10000000,
-            0b00000000,
-            0b00000001,
-            0b11100000,
-            0b10011000,
-            0b00000001,
-            0b00011100,
-            0b11100010,
-            0b00000011,
-            0b11111000,
-            0b01111111,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00000111,
-            0b11111111,
-            0b10000000,
-            0b00000000,
-            0b00000111,
-            0b01110000,
-            0b00000000,
-            0b00000010,
-            0b00110000,
-            0b01110001,
-            0b00000001,
-            0b11100001,
-            0b11111000,
-            0b00000000,
-            0b00000000,
-            0b00000100,
-            0b00001111,
-            0b10011111,
-            0b00000111,
-            0b00010000,
-            0b00001110,
-            0b00011100,
-            0b00001000,
-            0b00000000,
-            0b01100000,
-            0b00011000,
-            0b00000000,
-            0b01000001,
-            0b11100000,
-            0b00000001,
-            0b10000000,
-            0b00000100,
-            0b00001111,
-            0b11111110,
-            0b00000101,
-            0b00010000,
-            0b00011000,
-            0b11001110,
-            0b00011100,
-            0b00010001,
-            0b11000000,
-            0b00001100,
-            0b00100000,
-            0b01000001,
-            0b00010110,
-            0b00000001,
-            0b11000000,
-            0b00000000,
-            0b10000111,
-            0b10011100,
-            0b00000010,
-            0b00000000,
-            0b01110011,
-            0b11100011,
-            0b00000000,
-            0b00100011,
-            0b00000000,
-            0b00000111,
-            0b00010000,
-            0b00000001,
-            0b01111000,
-            0b00000000,
-            0b00000000,
-            0b00111001,
-            0b11000111,
-            0b11111000,
-            0b00000000,
-            0b00000000,
-            0b11100001,
-            0b11100001,
-            0b11000000,
-            0b10000110,
-            0b00000011,
-            0b00000001,
-            0b10000000,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00001110,
-            0b00110000,
-            0b10000011,
-            0b01110000,
-            0b00000000,
-            0b00000001,
-            0b10000001,
-            0b11100100,
-            0b11100001,
-            0b00011100,
-            0b00001111,
-            0b10000000,
-            0b11100010,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00000100,
-            0b00000000,
-            0b00001000,
-            0b11000000,
-            0b00000000,
-            0b01000111,
-            0b00000000,
-            0b11000000,
-            0b00110000,
-            0b00110000,
-            0b00011111,
-            0b11000000,
-            0b01110001,
-            0b00000000,
-            0b00000000,
-            0b00000001,
-            0b10000000,
-            0b00000000,
-            0b00001000,
-            0b00000000,
-            0b00000000,
-            0b00001110,
-            0b00000000,
-            0b00000001,
-            0b00011100,
-            0b01100000,
-            0b00111111,
-            0b11100000,
-            0b00011000,
-            0b01000000,
-            0b10000000,
-            0b00001000,
-            0b00000000,
-            0b01111111,
-            0b11100000,
-            0b00000000,
-            0b00000000,
-            0b00011100,
-            0b00100000,
-            0b10000001,
-            0b00001111,
-            0b11000000,
-            0b01111111,
-            0b11111000,
-            0b00001110,
-            0b00100000,
-            0b00000000,
-            0b00000011,
-            0b11101111,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b01110000,
-            0b01100000,
-            0b11000001,
-            0b00010011,
-            0b10000000,
-            0b00000000,
-            0b00000000,
-            0b01000111,
-            0b00000000,
-            0b00000001,
-            0b00000000,
-            0b00000000,
-            0b01011001,
-            0b00100010,
-            0b00000000,
-            0b00000000,
-            0b11100000,
-            0b00100000,
-            0b10000001,
-            0b00100110,
-            0b00100000,
-            0b00000000,
-            0b00000000,
-            0b11100001,
-            0b10000000,
-            0b00000000,
-            0b00100010,
-            0b11000101,
-            0b00000000,
-            0b00000111,
-            0b11000000,
-            0b01100001,
-            0b10000000,
-            0b01100000,
-            0b10000001,
-            0b10011100,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b01000000,
-            0b11100011,
-            0b00000001,
-            0b11011000,
-            0b00000000,
-            0b00100000,
-            0b00000000,
-            0b00000000,
-            0b01000111,
-            0b00000000,
-            0b10000000,
-            0b10000000,
-            0b00111000,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00010000,
-            0b00110001,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00000110,
-            0b00011111,
-            0b00000111,
-            0b11111000,
-            0b01100000,
-            0b00000000,
-            0b01000000,
-            0b00000000,
-            0b00000000,
-            0b00011000,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b11111111,
-            0b11111111,
-            0b11111111,
-            0b11111111,
-            0b11111111,
-            0b11111111,
-            0b11111111,
-            0b11111111,
-            0b11111111,
-            0b11111111,
-            0b11111111,
-            0b11111111,
-            0b00000000,
-            0b00100000,
-            0b00001111,
-            0b00000011,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b11000000,
-            0b01110000,
-            0b01000111,
-            0b00000000,
-            0b10000000,
-            0b00010000,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00010000,
-            0b00000000,
-            0b00000001,
-            0b00000000,
-            0b01110001,
-            0b00000000,
-            0b00111000,
-            0b01001100,
-            0b00010001,
-            0b10010000,
-            0b01100001,
-            0b00001111,
-            0b11110000,
-            0b00000000,
-            0b00011111,
-            0b11100001,
-            0b00000111,
-            0b00011111,
-            0b11110010,
-            0b00011100,
-            0b00000000,
-            0b00000000,
-            0b01001001,
-            0b01001111,
-            0b00000011,
-            0b10000000,
-            0b11100000,
-            0b00111111,
-            0b11110000,
-            0b00000000,
-            0b00111111,
-            0b11111000,
-            0b00001111,
-            0b00011111,
-            0b11110010,
-            0b10010010,
-            0b00001000,
-            0b00000000,
-            0b00001000,
-            0b00001111,
-            0b10001111,
-            0b10000011,
-            0b11111000,
-            0b00110000,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00111000,
-            0b00111111,
-            0b00011100,
-            0b00000000,
-            0b00010000,
-            0b11000000,
-            0b00001100,
-            0b00001000,
-            0b00001111,
-            0b11011111,
-            0b10000011,
-            0b10111000,
-            0b00111111,
-            0b10000000,
-            0b00000000,
-            0b00000000,
-            0b01111000,
-            0b01110011,
-            0b00011111,
-            0b11000000,
-            0b00010000,
-            0b00110000,
-            0b11110000,
-            0b00001000,
-            0b10001111,
-            0b11111111,
-            0b10000111,
-            0b00011000,
-            0b00011111,
-            0b11100000,
-            0b00000000,
-            0b00000000,
-            0b11100000,
-            0b11100011,
-            0b00001111,
-            0b11100001,
-            0b00010001,
-            0b00001111,
-            0b00001100,
-            0b00001000,
-            0b00001110,
-            0b01111011,
-            0b10000111,
-            0b11111110,
-            0b00000000,
-            0b01110000,
-            0b00000000,
-            0b00000111,
-            0b00000011,
-            0b11111111,
-            0b11000000,
-            0b01110000,
-            0b00010000,
-            0b00110000,
-            0b00000010,
-            0b00001000,
-            0b00001110,
-            0b00110011,
-            0b10001110,
-            0b00001110,
-            0b00000000,
-            0b01110000,
-            0b00000000,
-            0b00001110,
-            0b00000011,
-            0b11111111,
-            0b11000000,
-            0b01110000,
-            0b00010000,
-            0b11000000,
-            0b00000000,
-            0b11001001,
-            0b01001110,
-            0b00000011,
-            0b10011100,
-            0b00100011,
-            0b00111111,
-            0b11100000,
-            0b00000000,
-            0b00111111,
-            0b11111000,
-            0b00000011,
-            0b00011111,
-            0b11110000,
-            0b10010010,
-            0b00000000,
-            0b00010000,
-            0b00101000,
-            0b10001110,
-            0b00000011,
-            0b10011100,
-            0b00100011,
-            0b00111111,
-            0b11000000,
-            0b00000000,
-            0b00111111,
-            0b11111000,
-            0b00000011,
-            0b00011111,
-            0b11000001,
-            0b00010100,
-            0b00001100,
-            0b01010100,
-            0b00010000,
-            0b10000000,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b10000000,
-            0b00000000,
-            0b00000001,
-            0b00001000,
-            0b01001011,
-            0b00000011,
-            0b01000011,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b11000000,
-            0b11000000,
-            0b00000000,
-            0b01000000,
-            0b11111111,
-            0b11111111,
-            0b11111111,
-            0b11111111,
-            0b11111111,
-            0b11111111,
-            0b11111111,
-            0b11111111,
-            0b11111111,
-            0b11111111,
-            0b11111111,
-            0b11111111,
-            0b00000110,
-            0b00000000,
-            0b00010000,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00011101,
-            0b00110001,
-            0b10011001,
-            0b10010000,
-            0b00000111,
-            0b00100010,
-            0b00000001,
-            0b00101010,
-            0b01110000,
-            0b00000000,
-            0b01000111,
-            0b10000000,
-            0b00010000,
-            0b00111000,
-            0b00001101,
-            0b10001000,
-            0b10000001,
-            0b00010000,
-            0b00001000,
-            0b10010000,
-            0b00000011,
-            0b10011000,
-            0b00111000,
-            0b00000001,
-            0b00011000,
-            0b00000000,
-            0b00011111,
-            0b11000000,
-            0b00000000,
-            0b01100000,
-            0b00000101,
-            0b00001000,
-            0b00000001,
-            0b01111000,
-            0b01000100,
-            0b00000000,
-            0b00001000,
-            0b11010000,
-            0b10111010,
-            0b00110000,
-            0b01001100,
-            0b01000000,
-            0b00011111,
-            0b11100000,
-            0b00001001,
-            0b11000000,
-            0b00000000,
-            0b00100001,
-            0b00000001,
-            0b00010000,
-            0b00110000,
-            0b00010000,
-            0b00110000,
-            0b01110000,
-            0b11101110,
-            0b00000000,
-            0b00011111,
-            0b00000000,
-            0b01111111,
-            0b11110000,
-            0b00000011,
-            0b10000010,
-            0b00001110,
-            0b00000100,
-            0b01101101,
-            0b00000000,
-            0b00001000,
-            0b11001110,
-            0b01000000,
-            0b00110000,
-            0b11010110,
-            0b00000000,
-            0b00111001,
-            0b10000000,
-            0b01111101,
-            0b11111000,
-            0b00100110,
-            0b00000000,
-            0b01111111,
-            0b10001000,
-            0b01011101,
-            0b00000010,
-            0b10000111,
-            0b00000111,
-            0b10000000,
-            0b00011100,
-            0b01101100,
-            0b00000000,
-            0b01100000,
-            0b11100000,
-            0b00000000,
-            0b00000000,
-            0b00011100,
-            0b00000000,
-            0b11011111,
-            0b11100000,
-            0b11111101,
-            0b00000011,
-            0b10000111,
-            0b10111011,
-            0b00001000,
-            0b00000110,
-            0b00111000,
-            0b00000001,
-            0b11000000,
-            0b01110001,
-            0b10000000,
-            0b00000000,
-            0b00111000,
-            0b00000011,
-            0b11111111,
-            0b11110011,
-            0b11011101,
-            0b00000011,
-            0b10000100,
-            0b11110100,
-            0b00000000,
-            0b01000011,
-            0b10001111,
-            0b11100011,
-            0b10000010,
-            0b00011000,
-            0b00000000,
-            0b00000000,
-            0b01100000,
-            0b00000011,
-            0b11110011,
-            0b11110011,
-            0b11111101,
-            0b00000000,
-            0b10001010,
-            0b00111000,
-            0b00000000,
-            0b00100001,
-            0b11000000,
-            0b00000110,
-            0b00100000,
-            0b10001110,
-            0b00000000,
-            0b00000001,
-            0b11000010,
-            0b00000111,
-            0b11100000,
-            0b11100000,
-            0b00000000,
-            0b00000000,
-            0b00001100,
-            0b00110000,
-            0b00000000,
-            0b00001000,
-            0b01100000,
-            0b10011100,
-            0b01100000,
-            0b01000111,
-            0b00000000,
-            0b00000011,
-            0b10000000,
-            0b11111111,
-            0b11000000,
-            0b11100011,
-            0b11111111,
-            0b00000100,
-            0b10001001,
-            0b01001100,
-            0b00000000,
-            0b00100100,
-            0b00111000,
-            0b00111000,
-            0b11100000,
-            0b00100001,
-            0b10000000,
-            0b00000110,
-            0b00010000,
-            0b00000011,
-            0b11100001,
-            0b11000000,
-            0b00000000,
-            0b01111110,
-            0b11000101,
-            0b10000010,
-            0b00000000,
-            0b00100010,
-            0b00011100,
-            0b01100001,
-            0b11100000,
-            0b00000000,
-            0b11100000,
-            0b00011100,
-            0b00100000,
-            0b00000011,
-            0b11111011,
-            0b00000011,
-            0b11111111,
-            0b01001110,
-            0b00000111,
-            0b00000001,
-            0b10001000,
-            0b00100000,
-            0b10000111,
-            0b11000001,
-            0b11100000,
-            0b00000100,
-            0b01110000,
-            0b00111000,
-            0b00000100,
-            0b11000001,
-            0b11111110,
-            0b00000010,
-            0b00001101,
-            0b00001110,
-            0b00001100,
-            0b00000000,
-            0b01000000,
-            0b01111000,
-            0b01000011,
-            0b10000001,
-            0b11100000,
-            0b00000010,
-            0b00111000,
-            0b01110001,
-            0b00000100,
-            0b00000001,
-            0b11111100,
-            0b00000010,
-            0b00000001,
-            0b01111100,
-            0b00010000,
-            0b00000000,
-            0b00100001,
-            0b10001100,
-            0b00000000,
-            0b00010001,
-            0b11100000,
-            0b00100000,
-            0b10011111,
-            0b11100010,
-            0b00001100,
-            0b00000010,
-            0b00111000,
-            0b00000010,
-            0b11000101,
-            0b00000000,
-            0b00000100,
-            0b00000000,
-            0b00000111,
-            0b11111111,
-            0b00000000,
-            0b00111001,
-            0b11100000,
-            0b01111000,
-            0b01001111,
-            0b11001000,
-            0b01110000,
-            0b11100000,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b01001010,
-            0b01000100,
-            0b00000010,
-            0b01000011,
-            0b00000110,
-            0b00000000,
-            0b00010001,
-            0b11100000,
-            0b00100000,
-            0b00100111,
-            0b10010000,
-            0b00010001,
-            0b00000000,
-            0b00000000,
-            0b00001111,
-            0b11111111,
-            0b00000000,
-            0b00000000,
-            0b01110000,
-            0b11000000,
-            0b10001100,
-            0b00000100,
-            0b00000000,
-            0b11100000,
-            0b00000000,
-            0b00001011,
-            0b00000010,
-            0b00000100,
-            0b00000000,
-            0b00001110,
-            0b00010000,
-            0b00100000,
-            0b01000000,
-            0b00000000,
-            0b11111001,
-            0b11100000,
-            0b01110000,
-            0b00001110,
-            0b00000000,
-            0b01100000,
-            0b00000011,
-            0b00000111,
-            0b10000110,
-            0b00000100,
-            0b00001000,
-            0b10011111,
-            0b10010000,
-            0b00000000,
-            0b00000000,
-            0b00001100,
-            0b01110000,
-            0b11000000,
-            0b00100001,
-            0b10000100,
-            0b00000000,
-            0b00100001,
-            0b00000000,
-            0b00000011,
-            0b00000000,
-            0b00100100,
-            0b00000000,
-            0b10000111,
-            0b00010000,
-            0b00000000,
-            0b00000000,
-            0b00011110,
-            0b00100000,
-            0b00000000,
-            0b00100000,
-            0b00000100,
-            0b00000110,
-            0b00000000,
-            0b00000000,
-            0b00000011,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00000100,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00100000,
-            0b01000000,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-            0b00000000,
-        };
-
-    };
-
-};
-
-#endif // MAS245_LOGO_BITMAP_H
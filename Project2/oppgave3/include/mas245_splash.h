@@ -0,0 +1,31 @@
+#ifndef MAS245_SPLASH_H
+#define MAS245_SPLASH_H
+
+#include <kmk/image.h>
+#include <kmk/rle.h>
+
+namespace images {
+    namespace mas245splash {
+        // The GIMP export is included as is, wrapped in a namespace so its width/height/header_data stay local.
+        namespace gimp {
+            #include "mas245_logo_gimp_export.h"
+
+            // The colour map only serves HEADER_PIXEL and would warn as unused; the packing below takes any
+            // index but 0 as a lit pixel instead (src/generator_bench.cpp checks that against the colours).
+            constexpr auto& colourMap = header_data_cmap;
+        }
+
+        constexpr uint8_t width{gimp::width};
+        constexpr uint8_t height{gimp::height};
+        constexpr bool pageMajor{true};
+
+        // Packed at compile time, there is no generated file to keep in sync with the GIMP export.
+        constexpr auto pages = kmk::toPageMajor<gimp::width, gimp::height>(kmk::to_array(gimp::header_data));
+        static_assert(pages.size() == width * height / 8, "Splash must fill the 128x64 screen exactly");
+
+        constexpr auto rle = kmk::rle::encodeArray<kmk::rle::encodedSize(pages)>(pages);
+        static_assert(rle.size() < pages.size(), "RLE should never make the splash larger");
+    };
+};
+
+#endif // MAS245_SPLASH_H
@@ -0,0 +1,27 @@
+// kmk-asset-hash: 1e922bc8247e88ef
+// Generated by src/generator.cpp from res/pumpkin.pbm, do not edit.
+#ifndef PUMPKIN_BITMAP_H
+#define PUMPKIN_BITMAP_H
+
+#include <avr/pgmspace.h>
+
+namespace images {
+    namespace pumpkin {
+        constexpr uint8_t width{16};
+
+        constexpr uint8_t height{18};
+
+        constexpr bool pageMajor{false};
+
+        // Row-major, MSB first bitmap.
+        static const uint8_t PROGMEM bitmap[] = {
+            0x00, 0x20, 0x00, 0xe0, 0x01, 0x80, 0x01, 0x80, 0x01, 0x80, 0x03, 0xe0, 0x0f, 0xf8, 0x3f, 0xf8,
+            0x7f, 0xfe, 0x7f, 0xfe, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x7f, 0xfe, 0x7f, 0xfe, 0x1f, 0xf8,
+            0x1f, 0xf0, 0x07, 0xe0,
+        };
+
+    };
+
+};
+
+#endif // PUMPKIN_BITMAP_H
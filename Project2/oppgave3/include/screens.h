@@ -0,0 +1,221 @@
+#ifndef SCREENS_H
+#define SCREENS_H
+
+// The screens drawn by main.cpp. Templates over the display type, so src/render_screens.cpp can draw
+// exactly the same frames into the host emulator (kmk/emulator.h).
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include <kmk/can_stats.h>
+#include <kmk/compositor.h>
+#include <kmk/gfx.h>
+#include <kmk/path.h>
+#include <kmk/profile.h>
+#include <kmk/rle.h>
+#include <kmk/sequence.h>
+#include <kmk/ssd1306_buffer.h>
+#include <kmk/text.h>
+#include <kmk/widget.h>
+#include "font5x7_atlas.h"
+#include "mas245_splash.h"
+
+// lager størelsen til sirkelen og banen, banen regnes ut ved kompilering (0 til 360 grader i steg på 5)
+namespace animation {
+  constexpr int16_t centerX = 128 / 2;
+  constexpr int16_t centerY = 60;
+  constexpr int16_t radiusX = 50;
+  constexpr int16_t radiusY = 4;
+  constexpr int16_t circleRadius = 3;
+  // Same pixels as display.fillCircle(x, y, circleRadius), rasterized at compile time.
+  constexpr auto circle = kmk::ssd1306::circleMask<circleRadius>();
+
+  constexpr auto ellipse = kmk::path::ellipse<360 / 5 + 1>(centerX, centerY, radiusX, radiusY, 0.0, 5.0);
+}
+
+// Constant texts, rasterized at compile time so each one is a single blit.
+namespace labels {
+  constexpr const kmk::Font& font = fonts::font5x7::font;
+
+  constexpr auto title = KMK_PRERENDER(font, "MAS245 - Gruppe 3");
+  constexpr auto canStats = KMK_PRERENDER(font, "CAN-statistikk");
+  constexpr auto separator = KMK_PRERENDER(font, "-------------------");
+}
+
+// Startup: blank screen, splash and blinking before the CAN screen. Run from loop() as a kmk::Sequence, so CAN is
+// read from the first pass; the holds add up to the 6.6 s setup() used to spend in delay().
+namespace startup {
+  enum class Step : uint8_t {
+    Clear,
+    Splash,
+    Invert,
+    Normal,
+    Operational,
+  };
+
+  constexpr std::array<kmk::TimedStep<Step>, 7> steps{{
+    {Step::Clear, 2000},
+    {Step::Splash, 2000},
+    {Step::Invert, 500},
+    {Step::Normal, 1000},
+    {Step::Invert, 100},
+    {Step::Normal, 1000},
+    {Step::Operational, 0},
+  }};
+}
+
+namespace screens {
+  template<typename Display>
+  void drawSplash(Display& display) {
+    namespace splash = images::mas245splash;
+    // Decode the compressed splash straight into the framebuffer, no per-pixel drawPixel calls.
+    if constexpr (splash::pageMajor) {
+      // Same layout as the framebuffer, so decoding is plain byte copies and memsets.
+      kmk::rle::decode(splash::rle.data(), splash::rle.size(),
+                       kmk::ssd1306::PageMajorSink{display.getBuffer(), static_cast<std::size_t>(display.width()), splash::width});
+    } else {
+      display.clearDisplay();
+      kmk::rle::decode(splash::rle.data(), splash::rle.size(),
+                       kmk::ssd1306::RowMajorSink{display.getBuffer(), splash::width});
+    }
+  }
+
+  template<typename Display>
+  void drawFrameWithTitleAndArc(Display& display) {
+    display.clearDisplay();
+    // lager overskriften
+    labels::title.draw(display.getBuffer(), display.width(), display.height(),
+                       (display.width() - labels::title.width) / 2, 2);
+    // lager linjen under overskriften
+    for (int16_t x = 0; x < display.width(); x++) {
+      int16_t y = 15 - (int16_t)(0.1 * (x - 64) * (x - 64) / 64);
+      display.drawPixel(x, y, SSD1306_WHITE);
+    }
+  }
+
+  /**
+   * "0x245 95/s" for one row of the busiest IDs, empty without an ID.
+  */
+  inline void formatIdRate(char* out, const kmk::can::IdStats* stats, uint32_t now) {
+    if (stats == nullptr) {
+      out[0] = '\0';
+      return;
+    }
+    out[0] = '0';
+    out[1] = 'x';
+    uint8_t length = static_cast<uint8_t>(2 + kmk::formatUnsigned(out + 2, stats->id, 16));
+    out[length++] = ' ';
+    length += kmk::formatUnsigned(out + length, static_cast<uint32_t>(stats->rateAt(now) + 0.5f));
+    out[length++] = '/';
+    out[length++] = 's';
+    out[length] = '\0';
+  }
+
+  /**
+   * The CAN statistics under the title: bus load, frame count, last ID and the TopRows busiest IDs with their
+   * rates. Heading and labels are static, everything else is retained fields that only redraw the characters
+   * that changed. One row fits above the animation; a panel of its own has room for three.
+  */
+  template<std::size_t TopRows>
+  struct CanStatsPage {
+    static_assert(TopRows >= 1 && TopRows <= 3, "Room for one to three rows of busy IDs");
+
+    kmk::TextField load{labels::font, "", 96, 16, 128};
+    kmk::NumberField received{labels::font, "Antall mottatt: ", 0, 24, 128};
+    kmk::NumberField lastId{labels::font, "Mottok sist ID: 0x", 0, 32, 128, 16};
+    std::array<kmk::TextField, TopRows> top = topFields(std::make_index_sequence<TopRows>{});
+
+    // Sets up the display, one line of text per page (8 pixels). Only the static parts, for the background.
+    template<typename Display>
+    void drawLabels(Display& display) {
+      uint8_t* buffer = display.getBuffer();
+      const int16_t w = display.width();
+      const int16_t h = display.height();
+
+      labels::canStats.draw(buffer, w, h, 0, 16);
+      received.drawLabel(display);
+      lastId.drawLabel(display);
+      for (const kmk::TextField& row : top) {
+        row.drawLabel(display);
+      }
+      if (TopRows == 1) {
+        labels::separator.draw(buffer, w, h, 0, 48);
+      }
+      load.invalidate();
+      received.invalidate();
+      lastId.invalidate();
+      for (kmk::TextField& row : top) {
+        row.invalidate();
+      }
+    }
+
+    template<typename Display, typename Background, typename Statistics>
+    void update(Display& display, const Background& background, const Statistics& stats,
+                uint32_t lastReceivedMessageID, uint32_t now) {
+      char text[kmk::TextField::maxLength + 1];
+      const uint32_t percent = static_cast<uint32_t>(stats.busLoad() * 100.0f + 0.5f);
+      const uint8_t digits = kmk::formatUnsigned(text, percent);
+      text[digits] = '%';
+      text[digits + 1] = '\0';
+      load.update(display, background, text);
+      received.update(display, background, stats.total());
+      lastId.update(display, background, lastReceivedMessageID);
+
+      const kmk::can::IdStats* busiest[TopRows]{};
+      stats.top(busiest, now);
+      for (std::size_t i = 0; i < TopRows; ++i) {
+        formatIdRate(text, busiest[i], now);
+        top[i].update(display, background, text);
+      }
+    }
+
+  private:
+    template<std::size_t... Rows>
+    static constexpr std::array<kmk::TextField, TopRows> topFields(std::index_sequence<Rows...>) {
+      constexpr const char* names[] = {"Topp 1: ", "Topp 2: ", "Topp 3: "};
+      return {kmk::TextField{labels::font, names[Rows], 0, static_cast<int16_t>(40 + 8 * Rows), 128}...};
+    }
+  };
+
+  // Draws the circle, and lets the compositor erase it again at the next frame
+  template<typename Display, typename Compositor>
+  void drawCircle(Display& display, Compositor& compositor, const kmk::Point& point) {
+    constexpr int16_t r = animation::circleRadius;
+    kmk::ssd1306::drawMask(display.getBuffer(), display.width(), display.height(), point.x - r, point.y - r,
+                           animation::circle, kmk::ssd1306::Color::White);
+    compositor.track(point.x - r, point.y - r, 2 * r + 1, 2 * r + 1);
+  }
+
+  /**
+   * Timing on the bottom line: the last frame and the 99th percentile, "f 412 p99 980us". Drawn over the
+   * animation on a black box and tracked, so the next compose() removes it again.
+  */
+  template<typename Display, typename Compositor>
+  void drawTimingOverlay(Display& display, Compositor& compositor, const kmk::profile::Histogram& frames,
+                         uint32_t ticksPerMicro) {
+    char text[32];
+    uint8_t length = 0;
+    auto append = [&](const char* part) {
+      for (; *part != '\0'; ++part) {
+        text[length++] = *part;
+      }
+    };
+    append("f ");
+    length += kmk::formatUnsigned(text + length, frames.last() / ticksPerMicro);
+    append(" p99 ");
+    length += kmk::formatUnsigned(text + length, frames.percentile(99) / ticksPerMicro);
+    append("us");
+    text[length] = '\0';
+
+    constexpr int16_t y = 56;
+    const int16_t w = static_cast<int16_t>(kmk::textWidth(labels::font, text) + 2);
+    kmk::ssd1306::fillRect(display.getBuffer(), display.width(), display.height(), 0, y, w, 8,
+                           kmk::ssd1306::Color::Black);
+    kmk::drawText(display.getBuffer(), display.width(), display.height(), labels::font, 1, y, text);
+    compositor.track(0, y, w, 8);
+  }
+}
+
+#endif // SCREENS_H
@@ -0,0 +1,35 @@
+// kmk-asset-hash: 27dd8b656c75f4ca
+// Generated by src/generator.cpp from res/spinner/,res/pumpkin.pbm, do not edit.
+#ifndef SPRITES_SHEET_H
+#define SPRITES_SHEET_H
+
+#include <kmk/sprite.h>
+
+namespace images {
+    namespace sprites {
+        // Sprite indices into the table below.
+        constexpr uint8_t spinner{0};
+        constexpr uint8_t pumpkin{1};
+
+        // Width, height, offset into data and frame count. Frames are page-major, see kmk::SpriteInfo.
+        constexpr kmk::SpriteInfo sprites[] = {
+            {8, 8, 0, 8},  // spinner
+            {16, 18, 78, 1},  // pumpkin
+        };
+
+        static const uint8_t PROGMEM data[] = {
+            0x04, 0x00, 0x82, 0x00, 0x80, 0x18, 0x06, 0x00, 0x82, 0x00, 0x02, 0x78, 0x78, 0x18, 0x08, 0x00,
+            0x80, 0x00, 0x04, 0xe0, 0xe0, 0x60, 0x60, 0x00, 0x08, 0x00, 0x04, 0x00, 0x60, 0x60, 0xe0, 0xe0,
+            0x80, 0x00, 0x06, 0x00, 0x02, 0x18, 0x78, 0x78, 0x82, 0x00, 0x06, 0x00, 0x02, 0x18, 0x1e, 0x1e,
+            0x82, 0x00, 0x08, 0x00, 0x04, 0x00, 0x06, 0x06, 0x07, 0x07, 0x80, 0x00, 0x08, 0x00, 0x80, 0x00,
+            0x04, 0x07, 0x07, 0x06, 0x06, 0x00, 0x06, 0x00, 0x82, 0x00, 0x02, 0x1e, 0x1e, 0x18, 0x25, 0x00,
+            0x0c, 0x00, 0x00, 0x80, 0x80, 0xc0, 0xc0, 0xe0, 0xfc, 0xfe, 0xe2, 0xe3, 0xc0, 0xc0, 0x80, 0x00,
+            0x02, 0x1c, 0x7f, 0x7f, 0x87, 0xff, 0x02, 0x7f, 0x7f, 0x1c, 0x80, 0x00, 0x01, 0x01, 0x01, 0x83,
+            0x03, 0x00, 0x01, 0x81, 0x00, 0x02, 0x00, 0xad, 0x00,
+        };
+
+    };
+
+};
+
+#endif // SPRITES_SHEET_H
@@ -0,0 +1,321 @@
+// Verification and throughput of the CAN receive path and statistics, and a check of the transmit scheduler,
+// in ../lib/kmk on the host.
+// Build and run with: pio run -e can_bench && .pio/build/can_bench/program [--frames <n>]
+#include <atomic>
+#include <cmath>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <kmk/can.h>
+#include <kmk/can_stats.h>
+#include <kmk/can_tx.h>
+#include <kmk/spsc_ring.h>
+
+namespace
+{
+    using Ring = kmk::SpscRing<kmk::can::Frame, 256>;
+
+    // Frame number n carries n in its id and, byte by byte, in its data, so a torn copy shows up.
+    kmk::can::Frame numbered(uint32_t n) {
+        kmk::can::Frame frame{n, n, 8, false, {}};
+        for (uint8_t i = 0; i < 8; ++i) {
+            frame.data[i] = static_cast<uint8_t>(n >> (i % 4 * 8));
+        }
+        return frame;
+    }
+
+    bool intact(const kmk::can::Frame& frame) {
+        const kmk::can::Frame expected = numbered(frame.id);
+        return frame.micros == frame.id && std::memcmp(frame.data, expected.data, sizeof(frame.data)) == 0;
+    }
+
+    /**
+     * A producer thread stands in for the receive interrupt and pushes frames numbered 0..frames-1 in bursts of
+     * burst frames gapMicros apart; the calling thread drains like loop(), pausing pauseMicros between drains.
+     * Every frame must either arrive intact and in order or be counted as an overflow.
+    */
+    bool run(const char* name, uint32_t frames, uint32_t burst, uint32_t gapMicros, uint32_t pauseMicros) {
+        Ring ring;
+        std::atomic<bool> done{false};
+        const auto start = std::chrono::steady_clock::now();
+        std::thread producer([&] {
+            for (uint32_t n = 0; n < frames; ++n) {
+                ring.push(numbered(n));
+                if ((n + 1) % burst == 0) {
+                    // The time between frames on the bus. Sleeping is far too coarse; yielding lets the
+                    // consumer run even on a single core.
+                    const auto until = std::chrono::steady_clock::now() + std::chrono::microseconds(gapMicros);
+                    while (std::chrono::steady_clock::now() < until) {
+                        std::this_thread::yield();
+                    }
+                }
+            }
+            done.store(true, std::memory_order_release);
+        });
+
+        uint64_t received = 0;
+        uint64_t drains = 0;
+        uint64_t bad = 0;
+        int64_t last = -1;
+        std::size_t mostAtOnce = 0;
+        for (bool finished = false; !finished;) {
+            finished = done.load(std::memory_order_acquire);
+            const std::size_t count = ring.drain([&](const kmk::can::Frame& frame) {
+                bad += !intact(frame) || static_cast<int64_t>(frame.id) <= last;
+                last = frame.id;
+                ++received;
+            });
+            mostAtOnce = count > mostAtOnce ? count : mostAtOnce;
+            ++drains;
+            if (pauseMicros > 0) {
+                std::this_thread::sleep_for(std::chrono::microseconds(pauseMicros));
+            } else if (count == 0) {
+                std::this_thread::yield();
+            }
+        }
+        producer.join();
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        const bool ok = bad == 0 && received + ring.overflows() == frames && ring.size() == 0;
+        std::printf("  %-22s %10llu %10u %8llu %10zu %12.1f %s\n", name, static_cast<unsigned long long>(received),
+                    ring.overflows(), static_cast<unsigned long long>(bad), mostAtOnce, frames / seconds / 1e6,
+                    ok ? "ok" : "FAILED");
+        return ok;
+    }
+
+    /**
+     * kmk::can::Statistics against traffic with known numbers: three periodic IDs, one of them extended with the
+     * same number as a standard one, plus one-off IDs until the table is full. Then the cost of record().
+    */
+    bool statistics() {
+        using Stats = kmk::can::Statistics<64>;
+        Stats stats(250000);
+        const kmk::can::Frame periodic[] = {
+            {0, 0x245, 4, false, {}},
+            {0, 0x100, 8, false, {}},
+            {0, 0x100, 8, true, {}},
+        };
+        const uint32_t periods[] = {1000, 10000, 2500};  // us: 1000, 100 and 400 frames/s.
+        uint64_t bits = 0;
+        for (uint32_t now = 0; now < 2000000; now += 500) {
+            for (std::size_t i = 0; i < 3; ++i) {
+                if (now % periods[i] == 0) {
+                    kmk::can::Frame frame = periodic[i];
+                    frame.micros = now;
+                    frame.data[0] = static_cast<uint8_t>(now / periods[i]);
+                    stats.record(frame);
+                    bits += now >= 1000000 ? kmk::can::frameBits(frame.length, frame.extended) : 0;
+                }
+            }
+        }
+        stats.update(2000000);
+
+        bool ok = true;
+        auto check = [&](const char* what, bool good) {
+            std::printf("  %-58s %s\n", what, good ? "ok" : "FAILED");
+            ok = ok && good;
+        };
+        const kmk::can::IdStats* fast = stats.find(0x245);
+        const kmk::can::IdStats* slow = stats.find(0x100);
+        const kmk::can::IdStats* extended = stats.find(0x100, true);
+        check("every ID found, standard and extended 0x100 apart", fast && slow && extended && slow != extended);
+        check("counts", fast && fast->count == 2000 && slow->count == 200 && extended->count == 800);
+        check("gaps min/avg/max", fast && fast->minGap == 1000 && fast->meanGap() == 1000 && fast->maxGap == 1000);
+        check("last payload", slow && slow->data[0] == 199);
+        check("rates within 1 %", fast && std::fabs(fast->rateAt(2000000) - 1000.0f) < 10.0f
+                                  && std::fabs(extended->rateAt(2000000) - 400.0f) < 4.0f);
+        const float expectedLoad = static_cast<float>(bits) / 250000.0f;
+        check("bus load of the last second", std::fabs(stats.busLoad() - expectedLoad) < 0.001f);
+        std::printf("    bus load %.1f %%, 0x245 %.1f/s, ext 0x100 %.1f/s\n", stats.busLoad() * 100.0,
+                    fast ? fast->rateAt(2000000) : 0.0f, extended ? extended->rateAt(2000000) : 0.0f);
+
+        {
+            // loop() calls update(micros()) after draining the ring, so a frame received before it can be
+            // recorded after it, stamped before the window start.
+            Stats late(250000);
+            late.record({500000, 0x245, 8, false, {}});
+            late.update(1000000);
+            const float firstLoad = late.busLoad();
+            late.record({999900, 0x245, 8, false, {}});
+            const bool kept = late.busLoad() == firstLoad && firstLoad > 0.0f;
+            late.update(2000000);
+            check("a frame stamped before the window start stays in it",
+                  kept && late.busLoad() == firstLoad);
+        }
+
+        const kmk::can::IdStats* top[2]{};
+        check("top two by rate", stats.top(top, 2000000) == 2 && top[0] == fast && top[1] == extended);
+        // Silent for 5 s: its rate falls to 1 frame per 5 s, so it drops out of the top.
+        stats.record({7000000, 0x555, 1, false, {}});
+        stats.record({7000100, 0x555, 1, false, {}});
+        check("an ID that went silent falls out of the top", stats.top(top, 7000100) == 2 && top[0]->id == 0x555);
+
+        for (uint32_t id = 0x600; stats.size() < Stats::maxIds; ++id) {
+            stats.record({7100000, id, 8, false, {}});
+        }
+        stats.record({7100000, 0x7FF, 8, false, {}});
+        check("a full table counts new IDs as untracked", stats.untracked() == 1 && stats.find(0x7FF) == nullptr
+                                                          && stats.find(0x245) == fast);
+
+        // Cost of record() with the table full: 48 IDs, each frame a different one.
+        uint32_t ids[Stats::maxIds];
+        std::size_t known = 0;
+        stats.forEach([&](const kmk::can::IdStats& id) { ids[known++] = id.id; });
+        const uint32_t rounds = 200000;
+        const auto start = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < rounds * Stats::maxIds; ++i) {
+            stats.record({8000000 + i, ids[i % known], 8, false, {}});
+        }
+        const double nanos = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count()
+                             / (rounds * Stats::maxIds);
+        std::printf("    record() with %zu IDs: %.1f ns per frame\n", known, nanos);
+        return ok;
+    }
+
+    /**
+     * Stands in for the driver's TX queue: takes up to room frames, and logs them.
+    */
+    struct FakeBus {
+        std::size_t room{0};
+        std::vector<kmk::can::Frame> sent;
+
+        bool write(const kmk::can::Frame& frame) {
+            if (room == 0) {
+                return false;
+            }
+            --room;
+            sent.push_back(frame);
+            return true;
+        }
+    };
+
+    struct Value {
+        uint16_t value;
+
+        static constexpr auto layout = kmk::can::layout<2>("Value", kmk::can::Field<&Value::value, 0, 16>{"Value"});
+    };
+
+    uint16_t valueOf(const kmk::can::Frame& frame) {
+        Value value{};
+        kmk::can::decode(frame.data, frame.length, value);
+        return value.value;
+    }
+
+    /**
+     * kmk::can::TxScheduler with the Pong classes (state, paddle, periodic role) and a chatty class below them,
+     * on a bus that takes a given number of frames per 1 ms tick.
+    */
+    bool transmit() {
+        bool ok = true;
+        auto check = [&](const char* what, bool good) {
+            std::printf("  %-58s %s\n", what, good ? "ok" : "FAILED");
+            ok = ok && good;
+        };
+        enum : uint8_t { State, Paddle, Role, Chatter, Count };
+        constexpr std::array<kmk::can::TxClass, Count> classes{{
+            {0, 0, 40000},
+            {1, 0, 40000},
+            {2, 250000, 0},
+            {3, 0, 20000},
+        }};
+
+        {
+            // One frame per tick, and everything queued every tick: the state frame always goes first.
+            kmk::can::TxScheduler<Count> tx(classes);
+            FakeBus bus;
+            for (uint32_t now = 0; now < 1000000; now += 1000) {
+                tx.queue(Chatter, 0x700, Value{static_cast<uint16_t>(now / 1000)}, now);
+                tx.queue(State, 53, Value{static_cast<uint16_t>(now / 1000)}, now);
+                bus.room = 1;
+                tx.pump(now, bus);
+            }
+            const kmk::can::TxCounters& state = tx.counters(State);
+            const kmk::can::TxCounters& chatter = tx.counters(Chatter);
+            check("a saturated bus sends the state every tick, never late", state.sent == 1000 && state.late == 0
+                                                                            && state.maxDelay == 0);
+            check("the chatter below it is replaced, never sent", chatter.sent == 0 && chatter.coalesced == 999);
+        }
+        {
+            // Queued three times before a pump: only the newest goes.
+            kmk::can::TxScheduler<Count> tx(classes);
+            FakeBus bus{8, {}};
+            for (uint16_t i = 1; i <= 3; ++i) {
+                tx.queue(Paddle, 23, Value{i}, 0);
+            }
+            tx.pump(0, bus);
+            check("coalescing keeps the newest frame", bus.sent.size() == 1 && valueOf(bus.sent[0]) == 3
+                                                       && tx.counters(Paddle).coalesced == 2);
+        }
+        {
+            // Full for 50 ms: the state frame waits past its deadline and is dropped; with room 10 ms late,
+            // the next one goes out late.
+            kmk::can::TxScheduler<Count> tx(classes);
+            FakeBus bus;
+            tx.queue(State, 53, Value{1}, 0);
+            for (uint32_t now = 0; now <= 50000; now += 1000) {
+                tx.pump(now, bus);
+            }
+            tx.queue(State, 53, Value{2}, 60000);
+            tx.pump(60000, bus);
+            bus.room = 1;
+            tx.pump(70000, bus);
+            const kmk::can::TxCounters& state = tx.counters(State);
+            check("deadline drops, late and the delay", state.dropped == 1 && state.sent == 1 && state.late == 1
+                                                         && state.maxDelay == 10000 && valueOf(bus.sent[0]) == 2);
+        }
+        {
+            // 250 ms heartbeat, starting just before the micros() wrap-around; a change at 600 ms goes out at once
+            // and restarts the rhythm.
+            kmk::can::TxScheduler<Count> tx(classes);
+            FakeBus bus;
+            const uint32_t start = 0xFFFFFFFFu - 100000;
+            std::vector<uint32_t> times;
+            for (uint32_t t = 0; t < 1000000; t += 1000) {
+                const uint32_t now = start + t;
+                tx.queue(Role, t < 600000 ? 101 : 100, Value{static_cast<uint16_t>(t < 600000 ? 0 : 1)}, now);
+                bus.room = 4;
+                if (tx.pump(now, bus) > 0) {
+                    times.push_back(t / 1000);
+                }
+            }
+            check("periodic every 250 ms, at once on change, across the wrap",
+                  times == std::vector<uint32_t>{0, 250, 500, 600, 850} && bus.sent.back().id == 100);
+        }
+        return ok;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    uint32_t frames = 2000000;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg(argv[i]);
+        if (arg == "--frames" && i + 1 < argc) {
+            frames = static_cast<uint32_t>(std::stoul(argv[++i]));
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--frames <n>]\n";
+            return 1;
+        }
+    }
+
+    std::cout << "SpscRing<Frame, 256>, producer thread as the receive interrupt\n";
+    std::printf("  %-22s %10s %10s %8s %10s %12s\n", "consumer", "received", "overflows", "bad", "max drain",
+                "Mframes/s");
+    // Bursts of 64 frames 20 us apart, some hundred times a saturated 250 kbit/s bus, drained without pause.
+    bool ok = run("draining flat out", frames, 64, 20, 0);
+    // Drains rarely compared with the producer, so the ring overflows and the counter has to account for it.
+    ok = run("draining every 1 ms", frames / 10, 64, 20, 1000) && ok;
+
+    std::cout << "Statistics<64>, per CAN ID\n";
+    ok = statistics() && ok;
+    std::cout << "TxScheduler, Pong message classes\n";
+    ok = transmit() && ok;
+    std::cout << (ok ? "ok" : "FAILED") << '\n';
+    return ok ? 0 : 1;
+}
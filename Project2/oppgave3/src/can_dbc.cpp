@@ -0,0 +1,215 @@
+// Exports the CAN messages of this firmware and the Pong players (include/can_messages.h, kmk/pong_can.h) as a
+// DBC file, so PCAN-View and other tools show the fields instead of raw bytes.
+// Build and run with: pio run -e can_dbc && .pio/build/can_dbc/program [--out mas245.dbc]
+//   .pio/build/can_dbc/program --selftest
+// --selftest checks the generated encode/decode against a bit-by-bit reference and the old hand-written shifts.
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include <kmk/can_schema.h>
+#include <kmk/pong_can.h>
+
+#include "can_messages.h"
+
+namespace
+{
+    // Group numbers of the two Pong players, as set in their main.cpp.
+    constexpr uint8_t player1Group = 3;
+    constexpr uint8_t player2Group = 2;
+
+    /**
+     * DBC numbers Motorola bits MSB first within each byte (bit 7 of byte 0 is 7, then 6 ... 0, 15, 14 ...) and
+     * gives the start of the field's most significant bit; Field counts them in order through the bytes.
+    */
+    template<typename F>
+    int dbcStart() {
+        return F::order == kmk::can::ByteOrder::Intel ? F::start : F::start / 8 * 8 + 7 - F::start % 8;
+    }
+
+    template<typename F>
+    void writeSignal(std::ostream& out, const F& field) {
+        const long long min = F::isSigned ? -(1LL << (F::bits - 1)) : 0;
+        const long long max = std::is_same<typename F::Raw, bool>::value ? 1
+                              : F::isSigned ? (1LL << (F::bits - 1)) - 1 : (1LL << F::bits) - 1;
+        out << " SG_ " << field.name << " : " << dbcStart<F>() << '|' << int{F::bits} << '@'
+            << (F::order == kmk::can::ByteOrder::Intel ? '1' : '0') << (F::isSigned ? '-' : '+') << " (1,0) ["
+            << min << '|' << max << "] \"" << field.unit << "\" Vector__XXX\n";
+    }
+
+    template<typename Message>
+    void writeMessage(std::ostream& out, uint32_t id, const std::string& name, const char* sender) {
+        out << "BO_ " << id << ' ' << name << ": " << int{kmk::can::LayoutOf<Message>::length} << ' ' << sender << '\n';
+        std::apply([&](const auto&... fields) { (writeSignal(out, fields), ...); }, Message::layout.fields);
+        out << '\n';
+    }
+
+    std::string dbc() {
+        std::ostringstream out;
+        out << "VERSION \"\"\n\nNS_ :\n\nBS_:\n\nBU_: Oppgave3 Player1 Player2\n\n";
+        writeMessage<messages::Coordinates>(out, messages::Coordinates::id, "Coordinates", "Oppgave3");
+        for (const auto& [group, player] : {std::pair{player1Group, "Player1"}, std::pair{player2Group, "Player2"}}) {
+            const std::string suffix = "_" + std::to_string(group);
+            writeMessage<kmk::pong::Paddle>(out, kmk::pong::paddleId(group), "Paddle" + suffix, player);
+            writeMessage<kmk::pong::GameState>(out, kmk::pong::stateId(group), "GameState" + suffix, player);
+        }
+        writeMessage<kmk::pong::Role>(out, kmk::pong::masterId, "RoleMaster", "Player1");
+        writeMessage<kmk::pong::Role>(out, kmk::pong::notMasterId, "RoleNotMaster", "Player1");
+        // Both players send the role messages.
+        out << "BO_TX_BU_ " << kmk::pong::masterId << " : Player1,Player2;\n";
+        out << "BO_TX_BU_ " << kmk::pong::notMasterId << " : Player1,Player2;\n\n";
+        out << "CM_ BO_ " << messages::Coordinates::id << " \"Circle position, sent after every animation step\";\n";
+        out << "CM_ SG_ " << kmk::pong::stateId(player1Group) << " PaddleY \"The master's own paddle\";\n";
+        out << "CM_ SG_ " << kmk::pong::stateId(player2Group) << " PaddleY \"The master's own paddle\";\n";
+        return out.str();
+    }
+
+    /**
+     * Reference for Field: one bit at a time, straight from the DBC definitions.
+    */
+    void referencePut(uint8_t* data, int start, int bits, bool motorola, uint32_t value) {
+        for (int k = 0; k < bits; ++k) {
+            const bool bit = (value >> k) & 1u;
+            const int position = motorola ? start + bits - 1 - k : start + k;  // In order through the bytes.
+            const int shift = motorola ? 7 - position % 8 : position % 8;
+            data[position / 8] = static_cast<uint8_t>((data[position / 8] & ~(1u << shift)) | (bit << shift));
+        }
+    }
+
+    enum class Mode : uint8_t { Off, Slow, Fast, Boost };
+
+    // Odd widths and positions, both byte orders, sharing bytes.
+    struct Mixed {
+        int16_t a;
+        uint8_t b;
+        Mode c;
+        uint16_t d;
+        int32_t e;
+        bool f;
+
+        static constexpr auto layout = kmk::can::layout<8>("Mixed",
+                                                           kmk::can::Field<&Mixed::a, 4, 12>{"A"},
+                                                           kmk::can::Field<&Mixed::b, 1, 3>{"B"},
+                                                           kmk::can::Field<&Mixed::c, 18, 2>{"C"},
+                                                           kmk::can::Field<&Mixed::d, 22, 10, kmk::can::ByteOrder::Motorola>{"D"},
+                                                           kmk::can::Field<&Mixed::e, 32, 31, kmk::can::ByteOrder::Motorola>{"E"},
+                                                           kmk::can::Field<&Mixed::f, 56, 1>{"F"});
+    };
+
+    int selftest() {
+        bool ok = true;
+        auto check = [&](const char* what, bool good) {
+            std::printf("  %-58s %s\n", what, good ? "ok" : "FAILED");
+            ok = ok && good;
+        };
+
+        std::mt19937 random(245);
+        bool matches = true;
+        bool roundTrips = true;
+        for (int i = 0; i < 100000; ++i) {
+            const uint32_t r = random();
+            const Mixed in{static_cast<int16_t>(static_cast<int16_t>(r << 4) >> 4), static_cast<uint8_t>(r % 8),
+                           static_cast<Mode>(r >> 30), static_cast<uint16_t>(random() % 1024),
+                           static_cast<int32_t>(random()) >> 1, (r & 0x100) != 0};
+            uint8_t data[8];
+            std::memset(data, 0xFF, sizeof(data));
+            const uint8_t length = kmk::can::encode(in, data);
+            uint8_t expected[8]{};
+            referencePut(expected, 4, 12, false, static_cast<uint16_t>(in.a));
+            referencePut(expected, 1, 3, false, in.b);
+            referencePut(expected, 18, 2, false, static_cast<uint8_t>(in.c));
+            referencePut(expected, 22, 10, true, in.d);
+            referencePut(expected, 32, 31, true, static_cast<uint32_t>(in.e));
+            referencePut(expected, 56, 1, false, in.f);
+            matches = matches && length == 8 && std::memcmp(data, expected, sizeof(data)) == 0;
+
+            Mixed out{};
+            roundTrips = roundTrips && kmk::can::decode(data, length, out) && out.a == in.a && out.b == in.b
+                         && out.c == in.c && out.d == in.d && out.e == in.e && out.f == in.f;
+        }
+        check("encode() equals the bit-by-bit reference, unused bits zero", matches);
+        check("decode() returns what was encoded, signs extended", roundTrips);
+
+        // The shifts main.cpp and the Pong players used before.
+        bool sameBytes = true;
+        for (int i = 0; i < 10000; ++i) {
+            const int16_t x = static_cast<int16_t>(random());
+            const int16_t y = static_cast<int16_t>(random());
+            const int16_t p = static_cast<int16_t>(random());
+            uint8_t data[8]{};
+            uint8_t hand[8]{};
+            sameBytes = sameBytes && kmk::can::encode(messages::Coordinates{x, y}, data) == 4;
+            hand[0] = x & 0xFF;
+            hand[1] = (x >> 8) & 0xFF;
+            hand[2] = y & 0xFF;
+            hand[3] = (y >> 8) & 0xFF;
+            sameBytes = sameBytes && std::memcmp(data, hand, sizeof(data)) == 0;
+
+            sameBytes = sameBytes && kmk::can::encode(kmk::pong::GameState{x, y, p}, data) == 6;
+            hand[4] = p & 0xFF;
+            hand[5] = (p >> 8) & 0xFF;
+            sameBytes = sameBytes && std::memcmp(data, hand, sizeof(data)) == 0;
+
+            sameBytes = sameBytes && kmk::can::encode(kmk::pong::Paddle{p}, data) == 2 && data[0] == (p & 0xFF)
+                        && data[1] == ((p >> 8) & 0xFF);
+        }
+        const uint8_t master[] = {1};
+        const uint8_t notMaster[] = {0};
+        kmk::pong::Role role{false};
+        sameBytes = sameBytes && kmk::can::decode(master, 1, role) && role.master
+                    && kmk::can::decode(notMaster, 1, role) && !role.master;
+        check("the old hand-packed bytes, unchanged on the wire", sameBytes);
+
+        kmk::pong::GameState state{1, 2, 3};
+        const uint8_t tooShort[4]{};
+        check("a short frame is refused", !kmk::can::decode(tooShort, 4, state) && state.ballX == 1);
+
+        const std::string text = dbc();
+        check("DBC: the coordinates and both players' game state",
+              text.find("BO_ 581 Coordinates: 4 Oppgave3\n SG_ X : 0|16@1- (1,0) [-32768|32767]") != std::string::npos
+              && text.find("BO_ 53 GameState_3: 6 Player1\n") != std::string::npos
+              && text.find("BO_ 52 GameState_2: 6 Player2\n") != std::string::npos);
+        check("DBC: Motorola start bit of a field in bytes 2 and 3", dbcStart<kmk::can::Field<&Mixed::d, 16, 16,
+                                                                     kmk::can::ByteOrder::Motorola>>() == 23);
+
+        std::cout << (ok ? "ok" : "FAILED") << '\n';
+        return ok ? 0 : 1;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    std::string outPath;
+    bool runSelftest = false;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg(argv[i]);
+        if (arg == "--out" && i + 1 < argc) {
+            outPath = argv[++i];
+        } else if (arg == "--selftest") {
+            runSelftest = true;
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--out mas245.dbc]\n"
+                      << "       " << argv[0] << " --selftest\n";
+            return 1;
+        }
+    }
+    if (runSelftest) {
+        return selftest();
+    }
+
+    if (outPath.empty()) {
+        std::cout << dbc();
+        return 0;
+    }
+    std::ofstream(outPath) << dbc();
+    std::cout << "Wrote " << outPath << '\n';
+    return 0;
+}
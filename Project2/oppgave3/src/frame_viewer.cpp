@@ -0,0 +1,418 @@
+// Viewer/recorder for what the firmware sends over USB serial: the log records (kmk/log.h) are printed as text,
+// and the framebuffer stream (kmk/stream.h) of a -D STREAM_FRAMES build is saved as images.
+// Build with: pio run -e frame_viewer, then
+//   .pio/build/frame_viewer/program /dev/ttyACM0 [--out frames] [--capture capture.pbm] [--frames <n>]
+//   .pio/build/frame_viewer/program --selftest
+// Log lines go to stdout with the time stamp in seconds, text the firmware prints directly passes through.
+// Every frame is written as frames/frame_<n>.pbm; --capture also appends them all to one multi-image PBM,
+// which ImageMagick and ffmpeg read as an animation.
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <pty.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include <kmk/can_stats.h>
+#include <kmk/compositor.h>
+#include <kmk/emulator.h>
+#include <kmk/log.h>
+#include <kmk/packet.h>
+#include <kmk/sprite.h>
+#include <kmk/stream.h>
+
+#include "log_messages.h"
+#include "screens.h"
+#include "sprites_sheet.h"
+
+namespace
+{
+    using Decoder = kmk::stream::FrameDecoder<128, 64>;
+
+    void makeRaw(int fd) {
+        termios tty{};
+        if (tcgetattr(fd, &tty) != 0) {
+            return;  // Not a terminal, e.g. a recorded file.
+        }
+        cfmakeraw(&tty);
+        tcsetattr(fd, TCSANOW, &tty);
+    }
+
+    std::string toPbm(const uint8_t* frame) {
+        // The emulated panel starts with the full screen as its address window, so one data write fills it.
+        kmk::emulator::Panel panel;
+        panel.data(frame, 128 * 8);
+        return panel.pbm();
+    }
+
+    // A log record as the line the viewer prints, or an empty string if it does not decode.
+    std::string logLine(const uint8_t* payload, std::size_t length) {
+        char text[256];
+        if (kmk::log::format(text, sizeof(text), payload, length, logs::formats, logs::Count) < 0) {
+            return {};
+        }
+        const uint32_t micros = kmk::log::timestamp(payload);
+        char line[300];
+        std::snprintf(line, sizeof(line), "[%4u.%06u] %s", micros / 1000000, micros % 1000000, text);
+        return line;
+    }
+
+    /**
+     * Port end for kmk::packet::Channel on a non-blocking file descriptor.
+    */
+    class FdOut {
+    public:
+        explicit FdOut(int fd) : fd_(fd) {}
+
+        int availableForWrite() const { return 4096; }
+
+        std::size_t write(const uint8_t* data, std::size_t count) {
+            const ssize_t written = ::write(fd_, data, count);
+            return written > 0 ? static_cast<std::size_t>(written) : 0;
+        }
+
+    private:
+        int fd_;
+    };
+
+    int record(const std::string& device, const std::filesystem::path& outDir, const std::string& capturePath,
+               long maxFrames) {
+        const int fd = device == "-" ? STDIN_FILENO : open(device.c_str(), O_RDONLY | O_NOCTTY);
+        if (fd < 0) {
+            throw std::runtime_error(device + ": " + std::strerror(errno));
+        }
+        makeRaw(fd);
+        std::ofstream capture;
+        if (!capturePath.empty()) {
+            capture.open(capturePath, std::ios::binary);
+        }
+
+        kmk::packet::Parser parser;
+        Decoder decoder;
+        long frames = 0;
+        long records = 0;
+        std::size_t badRecords = 0;
+        std::size_t received = 0;
+        uint8_t chunk[4096];
+        while (maxFrames < 0 || frames < maxFrames) {
+            const ssize_t count = read(fd, chunk, sizeof(chunk));
+            if (count <= 0) {
+                break;
+            }
+            received += static_cast<std::size_t>(count);
+            for (ssize_t i = 0; i < count; ++i) {
+                const kmk::packet::Parser::Result result = parser.feed(chunk[i]);
+                if (result == kmk::packet::Parser::Result::Outside) {
+                    std::cout.put(static_cast<char>(chunk[i]));
+                    continue;
+                }
+                if (result != kmk::packet::Parser::Result::Packet) {
+                    continue;
+                }
+                if (parser.type() == kmk::log::packetType) {
+                    const std::string line = logLine(parser.payload(), parser.length());
+                    badRecords += line.empty();
+                    records += !line.empty();
+                    if (!line.empty()) {
+                        std::cout << line << '\n';
+                    }
+                    continue;
+                }
+                if (!decoder.apply(parser.type(), parser.payload(), parser.length())) {
+                    continue;
+                }
+                if (frames == 0) {
+                    std::filesystem::create_directories(outDir);
+                }
+                const std::string pbm = toPbm(decoder.frame());
+                char name[32];
+                std::snprintf(name, sizeof(name), "frame_%05u.pbm", decoder.frameNumber());
+                std::ofstream(outDir / name, std::ios::binary) << pbm;
+                if (capture) {
+                    capture << pbm;
+                }
+                ++frames;
+            }
+            std::cout.flush();
+        }
+        std::cout << frames << " frames, " << records << " log records, " << received << " bytes, "
+                  << decoder.errors() + parser.errors() + badRecords << " bad packets\n";
+        return 0;
+    }
+
+    // Takes everything, for timing Logger::write() without a port.
+    struct NullOut {
+        int availableForWrite() const { return 1 << 16; }
+        std::size_t write(const uint8_t*, std::size_t count) { return count; }
+    };
+
+    // A port the host reads room bytes of between passes; 0 is a host that stopped reading.
+    struct SlowOut {
+        int room{0};
+        std::size_t taken{0};
+        int availableForWrite() const { return room; }
+        std::size_t write(const uint8_t*, std::size_t count) {
+            room -= static_cast<int>(count);
+            taken += count;
+            return count;
+        }
+    };
+
+    /**
+     * The log records on their own: format() against printf, a flood into a channel nobody pumps, which has to
+     * drop records instead of blocking, flush() on a port that stops and starts, and the cost of a write().
+    */
+    bool logChecks() {
+        bool ok = true;
+        auto check = [&](const char* what, bool good) {
+            std::cout << "  " << what << (good ? ": ok" : ": FAILED") << '\n';
+            ok = ok && good;
+        };
+
+        struct Capture {
+            std::vector<uint8_t> payload;
+            bool send(uint8_t, const uint8_t* data, std::size_t size) {
+                payload.assign(data, data + size);
+                return true;
+            }
+        } capture;
+        kmk::log::Logger<Capture> direct(capture);
+        const char* const formats[] = {"%d %u %x|%5.2f|%-4d|%c 100%%", "%d"};
+        direct.write(0, 42, int16_t{-300}, uint8_t{200}, 0xBEEFu, 3.14159f, -7, 'k');
+        char text[64];
+        kmk::log::format(text, sizeof(text), capture.payload.data(), capture.payload.size(), formats, 2);
+        char expected[64];
+        std::snprintf(expected, sizeof(expected), formats[0], -300, 200u, 0xBEEFu, 3.14159, -7, 'k');
+        check("format() matches printf", std::string(text) == expected && kmk::log::timestamp(capture.payload.data()) == 42);
+        check("records that do not match the table are refused",
+              kmk::log::format(text, sizeof(text), capture.payload.data(), capture.payload.size() - 4, formats, 1) < 0
+              && kmk::log::format(text, sizeof(text), capture.payload.data(), 4, formats, 2) < 0);
+
+        NullOut sink;
+        kmk::packet::Channel<NullOut, 256> stuck(sink);
+        kmk::log::Logger<decltype(stuck)> flooded(stuck);
+        uint32_t accepted = 0;
+        for (uint32_t i = 0; i < 1000; ++i) {
+            accepted += flooded.write(logs::CanSent, i, 10, 20);
+        }
+        // 4 + 13 + 1 bytes a record, 14 of them fit in 256.
+        check("a flood drops and counts records", accepted == 256 / 18 && flooded.dropped() == 1000 - accepted);
+
+        // 252 bytes queued; flush() before a report writes at most 64 per pass and never waits for the port.
+        SlowOut slow;
+        kmk::packet::Channel<SlowOut, 256> reportChannel(slow);
+        kmk::log::Logger<decltype(reportChannel)> reportLogger(reportChannel);
+        while (reportLogger.write(logs::CanSent, 0, 10, 20)) {
+        }
+        const bool heldUp = !reportChannel.flush(64) && slow.taken == 0;
+        int passes = 0;
+        bool bounded = true;
+        for (bool empty = false; !empty && passes < 100; ++passes) {
+            slow.room = 100;
+            const std::size_t before = slow.taken;
+            empty = reportChannel.flush(64);
+            bounded = bounded && slow.taken - before <= 64;
+        }
+        check("flush() returns at once while the host does not read, then drains 64 bytes a pass",
+              heldUp && bounded && passes == 4 && slow.taken == 252);
+
+        kmk::packet::Channel<NullOut, 1 << 16> channel(sink);
+        kmk::log::Logger<decltype(channel)> logger(channel);
+        const uint32_t records = 2000000;
+        const auto start = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < records; ++i) {
+            logger.write(logs::CanSent, i, static_cast<int16_t>(i), static_cast<int16_t>(i >> 3));
+            if (i % 1024 == 0) {
+                channel.pump();
+            }
+        }
+        const double nanos = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count()
+                             / records;
+        check("no records dropped while pumped", logger.dropped() == 0);
+        std::printf("  write() with two arguments: %.1f ns per record, pump included\n", nanos);
+        return ok;
+    }
+
+    /**
+     * End to end check on a pseudo-terminal: frames drawn with the screens from main.cpp in the emulator are
+     * streamed into the master side together with log records, read back from the slave side in raw mode, and
+     * every decoded frame must equal the emulator's framebuffer and every log line the text printf makes.
+     * The channel is deliberately small for part of the run, so dropped spans have to be caught up by later
+     * frames.
+    */
+    int selftest() {
+        int master = -1;
+        int slave = -1;
+        if (openpty(&master, &slave, nullptr, nullptr, nullptr) != 0) {
+            throw std::runtime_error(std::string("openpty: ") + std::strerror(errno));
+        }
+        makeRaw(slave);
+        fcntl(master, F_SETFL, O_NONBLOCK);
+        fcntl(slave, F_SETFL, O_NONBLOCK);
+
+        kmk::emulator::Display display;
+        kmk::ssd1306::Compositor<128, 64> compositor;
+        screens::CanStatsPage<1> page;
+        kmk::can::Statistics<64> stats(250000);
+        kmk::AnimationPlayer spinner(images::sprites::data, images::sprites::sprites[images::sprites::spinner],
+                                     display.width() - 8, 0);
+        FdOut out(master);
+        kmk::packet::Channel<FdOut> channel(out);
+        kmk::packet::Channel<FdOut, 256> smallChannel(out);
+        kmk::stream::FrameStreamer<decltype(channel)> streamer(channel);
+        kmk::stream::FrameStreamer<decltype(smallChannel)> smallStreamer(smallChannel);
+        kmk::log::Logger<decltype(channel)> logger(channel);
+        kmk::packet::Parser parser;
+        Decoder decoder;
+
+        std::vector<std::vector<uint8_t>> sent;
+        std::vector<std::string> logged;
+        std::size_t checked = 0;
+        std::size_t mismatches = 0;
+        std::size_t lines = 0;
+        std::size_t bytes = 0;
+        auto drain = [&](int waitMillis) {
+            uint8_t chunk[1024];
+            pollfd readable{slave, POLLIN, 0};
+            while (poll(&readable, 1, waitMillis) > 0) {
+                const ssize_t count = read(slave, chunk, sizeof(chunk));
+                if (count <= 0) {
+                    break;
+                }
+                bytes += static_cast<std::size_t>(count);
+                for (ssize_t i = 0; i < count; ++i) {
+                    if (parser.feed(chunk[i]) != kmk::packet::Parser::Result::Packet) {
+                        continue;
+                    }
+                    if (parser.type() == kmk::log::packetType) {
+                        mismatches += lines >= logged.size() || logLine(parser.payload(), parser.length()) != logged[lines];
+                        ++lines;
+                        continue;
+                    }
+                    if (decoder.apply(parser.type(), parser.payload(), parser.length())) {
+                        // Frames with spans left for later are not what was drawn, so they are not compared.
+                        const std::vector<uint8_t>& expected = sent.at(decoder.frameNumber());
+                        if (!expected.empty()) {
+                            mismatches += std::memcmp(expected.data(), decoder.frame(), expected.size()) != 0;
+                            ++checked;
+                        }
+                    }
+                }
+            }
+        };
+
+        // submit() returning true means everything that differs from what the viewer has was queued,
+        // including spans dropped from earlier frames, so the decoded frame must equal the drawing.
+        auto stream = [&](auto& s, auto& c) {
+            const bool complete = s.submit(display.getBuffer());
+            sent.push_back(complete ? std::vector<uint8_t>(display.getBuffer(), display.getBuffer() + 1024)
+                                    : std::vector<uint8_t>{});
+            while (c.queued() > 0) {
+                c.pump();
+                drain(0);
+            }
+            return complete;
+        };
+
+        screens::drawSplash(display);
+        stream(streamer, channel);
+        screens::drawFrameWithTitleAndArc(display);
+        page.drawLabels(display);
+        compositor.captureBackground(display.getBuffer());
+        spinner.reset(display.getBuffer(), display.width());
+        uint32_t now = 0;
+        for (int lap = 0; lap < 4; ++lap) {
+            for (const kmk::Point& point : animation::ellipse) {
+                compositor.compose(display.getBuffer());
+                // A few frames of a new ID per step, so counts, rates and the busiest IDs keep changing.
+                for (int i = 0; i < 7; ++i) {
+                    now += 2000;
+                    stats.record({now, static_cast<uint32_t>(0x100 + lap), 8, false, {}});
+                }
+                page.update(display, compositor, stats, 0x100 + lap, now);
+                screens::drawCircle(display, compositor, point);
+                spinner.next(display.getBuffer(), display.width());
+                // As sendCan() does after each frame; the expected line comes from printf.
+                const int16_t y = static_cast<int16_t>(point.y - 100 * lap);
+                logger.write(logs::CanSent, now, point.x, y);
+                char line[80];
+                std::snprintf(line, sizeof(line), "[%4u.%06u] Sent Coordinates - X: %d, Y: %d", now / 1000000,
+                              now % 1000000, point.x, y);
+                logged.emplace_back(line);
+                stream(streamer, channel);
+            }
+        }
+        drain(50);
+
+        // Second streamer with a 256 byte ring: the splash does not fit at once and has to catch up.
+        sent.clear();
+        screens::drawSplash(display);
+        for (int i = 0; i < 20 && !stream(smallStreamer, smallChannel); ++i) {
+            display.getBuffer()[i * 130 % 1024] ^= 0xFF;
+        }
+        const std::size_t dropped = smallStreamer.droppedSpans();
+        drain(50);
+
+        close(master);
+        close(slave);
+        const std::size_t errors = decoder.errors() + parser.errors();
+        std::cout << checked << " frames and " << lines << " log lines checked, " << mismatches << " mismatches, "
+                  << errors << " bad packets, " << dropped << " spans dropped by the small ring, " << bytes
+                  << " bytes\n";
+        const bool ok = logChecks() && mismatches == 0 && errors == 0 && checked > 0 && lines == logged.size()
+                        && dropped > 0 && std::memcmp(decoder.frame(), display.getBuffer(), 1024) == 0;
+        std::cout << (ok ? "ok" : "FAILED") << '\n';
+        return ok ? 0 : 1;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    std::string device;
+    std::filesystem::path outDir{"frames"};
+    std::string capturePath;
+    long maxFrames = -1;
+    bool runSelftest = false;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg(argv[i]);
+        if (arg == "--out" && i + 1 < argc) {
+            outDir = argv[++i];
+        } else if (arg == "--capture" && i + 1 < argc) {
+            capturePath = argv[++i];
+        } else if (arg == "--frames" && i + 1 < argc) {
+            maxFrames = std::stol(argv[++i]);
+        } else if (arg == "--selftest") {
+            runSelftest = true;
+        } else if (device.empty() && (arg == "-" || arg[0] != '-')) {
+            device = arg;
+        } else {
+            device.clear();
+            runSelftest = false;
+            break;
+        }
+    }
+    if (!runSelftest && device.empty()) {
+        std::cerr << "Usage: " << argv[0] << " <device|file|-> [--out frames] [--capture capture.pbm] [--frames <n>]\n"
+                  << "       " << argv[0] << " --selftest\n";
+        return 1;
+    }
+
+    try {
+        return runSelftest ? selftest() : record(device, outDir, capturePath, maxFrames);
+    } catch (const std::exception& e) {
+        std::cerr << "frame_viewer: " << e.what() << '\n';
+        return 1;
+    }
+}
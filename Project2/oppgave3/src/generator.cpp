@@ -1,87 +1,195 @@
 // Written by K. M. Knausgård 2023-10-21
-#include <array>
-#include <bitset>
+#include <algorithm>
+#include <cctype>
 #include <cstdint>
+#include <exception>
 #include <filesystem>
-#include <fstream>
 #include <iostream>
+#include <string>
+#include <vector>
 
-#include "mas245_logo_gimp_export.h"
+#include "generator/asset.h"
+#include "generator/batch.h"
+#include "generator/convert.h"
+#include "generator/font.h"
+#include "generator/sheet.h"
 
-namespace kmk
+namespace
 {
+    struct Result {
+        bool upToDate{false};
+        generator::Rendered rendered;
+        std::string error;
+    };
+
     /**
-     * This part is based on C++ features template metaprogramming with variadic templates and parameter pack expansion.
-     * (Not something you need to learn for MAS245 or MAS417).
-     * 
-     * Minimum C++ version for this is C++14.
-     * 
-     * Enables compile-time initialization of C++ std::array from C-style array, and also conversions. No run-time penalty,
-     * and also memory efficient. Could do this directly in the teensy project with a proper compiler, for now it is a separate executable.
+     * Sprite sheets hash every frame file, in order, and are rendered with the per-sprite frame streams.
     */
-    template<std::size_t N, std::size_t... Indices>
-    constexpr auto to_array_impl(const unsigned char (&arr)[N], std::index_sequence<Indices...>) {
-        return std::array<uint8_t, N>{arr[Indices]...};
+    Result convertSheet(const generator::Asset& asset, bool force) {
+        Result result;
+        const std::vector<generator::SheetSprite> sprites = generator::sheetSprites(asset);
+
+        generator::Hash hash;
+        hash.add(&generator::version, sizeof(generator::version));
+        hash.add(asset.name);
+        hash.add(asset.options.toString());
+        std::vector<generator::LoadedSprite> loaded;
+        for (const auto& sprite : sprites) {
+            generator::LoadedSprite frames{sprite.name, {}};
+            hash.add(sprite.name);
+            for (const auto& path : sprite.frames) {
+                const std::vector<uint8_t> data = generator::readFile(path);
+                hash.add(data.data(), data.size());
+                frames.frames.push_back(generator::loadImageFile(path, data, asset.options.dither));
+            }
+            loaded.push_back(frames);
+        }
+
+        if (!force && generator::isUpToDate(asset.output, hash.hex())) {
+            result.upToDate = true;
+            return result;
+        }
+        result.rendered = generator::renderSheet(asset, loaded, hash.hex());
+        return result;
     }
 
-    template<std::size_t N>
-    constexpr auto to_array(const unsigned char (&arr)[N]) {
-        return to_array_impl(arr, std::make_index_sequence<N>{});
+    /**
+     * Loads and renders one asset unless its output already carries the hash of the current input and options.
+     * Only reads files, so it can run on the worker threads; the writing is done afterwards in one pass.
+    */
+    Result convertAsset(const generator::Asset& asset, bool force) {
+        Result result;
+        try {
+            if (generator::isSheet(asset)) {
+                return convertSheet(asset, force);
+            }
+
+            const std::vector<uint8_t> data = generator::readFile(asset.input);
+
+            generator::Hash hash;
+            hash.add(&generator::version, sizeof(generator::version));
+            hash.add(asset.name);
+            hash.add(asset.options.toString());
+            hash.add(data.data(), data.size());
+
+            if (!force && generator::isUpToDate(asset.output, hash.hex())) {
+                result.upToDate = true;
+                return result;
+            }
+
+            const generator::Image image = generator::loadImageFile(asset.input, data, asset.options.dither);
+            result.rendered = asset.options.isFont()
+                ? generator::renderFont(asset, image, hash.hex())
+                : generator::renderHeader(asset, image, hash.hex());
+        } catch (const std::exception& error) {
+            result.error = error.what();
+        }
+        return result;
     }
 
-    template<std::size_t N>
-    constexpr auto compressBinaryArray(const std::array<uint8_t, N>& data) {
-        std::array<uint8_t, N / 8> compressedArray{};
-        for (std::size_t i = 0; i < N; i += 8) {
-            for (std::size_t j = 0; j < 8; ++j) {
-                compressedArray[i / 8] |= (data[i + j] << (7 - j)); // Fill in leftmost (MSB) bit first.
+    /**
+     * Every image file in a directory becomes images::<stem>, written to <out>/<stem>_bitmap.h.
+    */
+    std::vector<generator::Asset> collectBatch(const std::filesystem::path& inputDir, const std::filesystem::path& outputDir,
+                                               const generator::Options& options) {
+        std::vector<generator::Asset> assets;
+        for (const auto& entry : std::filesystem::directory_iterator(inputDir)) {
+            if (!entry.is_regular_file() || !generator::isImageFile(entry.path())) {
+                continue;
             }
+            const std::string name = generator::identifier(entry.path().stem().string());
+            assets.push_back({name, entry.path(), outputDir / (name + "_bitmap.h"), options});
         }
-        return compressedArray;
+        std::sort(assets.begin(), assets.end(), [](const auto& a, const auto& b) { return a.name < b.name; });
+        return assets;
     }
 }
 
 
-int main()
+int main(int argc, char* argv[])
 {
-    std::cout << "Starting binary logo generator.." << std::endl;
-
-    constexpr auto data_array = kmk::to_array(header_data);
-    constexpr auto compressedArray = kmk::compressBinaryArray(data_array);
+    std::cout << "Starting asset generator.." << std::endl;
 
-    std::filesystem::path dir("include");
-    std::filesystem::path file("mas245_logo_bitmap.h");
-    std::filesystem::path fullPath = dir / file;
+    // Without a batch directory every asset in the manifest is generated, res/assets.txt by default.
+    // The splash is not among them: include/mas245_splash.h packs it at compile time.
+    generator::Options options;
+    std::filesystem::path manifest("res/assets.txt");
+    std::filesystem::path batchDir;
+    std::filesystem::path outputDir("include");
+    unsigned threads = 0;
+    bool force = false;
 
-    std::ofstream outFile(fullPath);
-    if (!outFile) {
-        std::cerr << "Error opening file for writing\n";
-        return 1;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg(argv[i]);
+        if (arg == "--layout=page") {
+            options.pageMajor = true;
+        } else if (arg == "--layout=row") {
+            options.pageMajor = false;
+        } else if (arg == "--bin") {
+            options.bin = true;
+        } else if (arg.rfind("--dither=", 0) == 0 && generator::parseDither(arg.substr(9), options.dither)) {
+            // Parsed into options.dither.
+        } else if (arg == "--manifest" && i + 1 < argc) {
+            manifest = argv[++i];
+        } else if (arg == "--batch" && i + 1 < argc) {
+            batchDir = argv[++i];
+        } else if (arg == "--out" && i + 1 < argc) {
+            outputDir = argv[++i];
+        } else if (arg == "--threads" && i + 1 < argc) {
+            threads = static_cast<unsigned>(std::stoul(argv[++i]));
+        } else if (arg == "--force") {
+            force = true;
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--layout=page|row] [--bin] [--dither=threshold|ordered|floyd]\n"
+                      << "       [--manifest <file> | --batch <dir> [--out <dir>]] [--threads <n>] [--force]\n";
+            return 1;
+        }
     }
 
-    // Hard-coded template. A better option would be to create a template file for this using XML or JSON.
-    outFile << "#ifndef MAS245_LOGO_BITMAP_H\n";
-    outFile << "#define MAS245_LOGO_BITMAP_H\n\n";
-    outFile << "#include <avr/pgmspace.h>\n\n";
-    outFile << "namespace images {\n";
-    outFile << "    namespace mas245splash {\n";
-    outFile << "        constexpr uint8_t width{" << width << "};\n\n";
-    outFile << "        constexpr uint8_t height{" << height << "};\n";
-    outFile << "        static const uint8_t PROGMEM bitmap[] = {\n";
-   
-
-    for (const auto& byte : compressedArray) {
-        outFile << "            " << "0b" << std::bitset<8>(byte) << ",\n";
+    std::vector<generator::Asset> assets;
+    try {
+        if (!batchDir.empty()) {
+            assets = collectBatch(batchDir, outputDir, options);
+        } else {
+            assets = generator::readManifest(manifest);
+        }
+    } catch (const std::exception& error) {
+        std::cerr << "Error: " << error.what() << "\n";
+        return 1;
     }
 
-    outFile << "        };\n\n";
-    outFile << "    };\n\n";
-    outFile << "};\n\n";
-    outFile << "#endif // MAS245_LOGO_BITMAP_H\n";
+    std::vector<Result> results(assets.size());
+    generator::parallelFor(assets.size(), threads, [&](std::size_t i) { results[i] = convertAsset(assets[i], force); });
 
-    outFile.close();
+    int written = 0;
+    int failed = 0;
+    for (std::size_t i = 0; i < assets.size(); ++i) {
+        const auto& asset = assets[i];
+        const auto& result = results[i];
+        if (!result.error.empty()) {
+            std::cerr << "  " << asset.input.generic_string() << ": " << result.error << "\n";
+            ++failed;
+            continue;
+        }
+        if (result.upToDate) {
+            std::cout << "  " << asset.output.generic_string() << " is up to date." << std::endl;
+            continue;
+        }
 
-    std::cout << "Generated file " << fullPath << " successfully (hopefully, did not check for errors)." << std::endl;
+        try {
+            bool changed = false;
+            if (asset.options.bin) {
+                changed = generator::writeIfChanged(generator::binPath(asset), result.rendered.bin.data(), result.rendered.bin.size());
+            }
+            changed = generator::writeIfChanged(asset.output, result.rendered.header) || changed;
+            std::cout << "  " << asset.output.generic_string() << (changed ? " generated." : " unchanged.") << std::endl;
+            written += changed ? 1 : 0;
+        } catch (const std::exception& error) {
+            std::cerr << "  " << error.what() << "\n";
+            ++failed;
+        }
+    }
 
-    return 0;
+    std::cout << "Wrote " << written << " of " << assets.size() << " assets." << std::endl;
+    return failed == 0 ? 0 : 1;
 }
@@ -0,0 +1,436 @@
+#ifndef GENERATOR_ASSET_H
+#define GENERATOR_ASSET_H
+
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <kmk/image.h>
+#include <kmk/rle.h>
+
+namespace generator
+{
+    /**
+     * Bumped whenever the generated output changes for the same input, so old hashes stop matching.
+    */
+    constexpr uint32_t version = 3;
+
+    /**
+     * One byte per pixel, non-zero is lit.
+    */
+    struct Image {
+        std::size_t width{0};
+        std::size_t height{0};
+        std::vector<uint8_t> pixels;
+    };
+
+    enum class Dither {
+        Threshold,       // Plain 50 % threshold, fine for line art.
+        Ordered,         // 8x8 Bayer matrix, stable patterns between animation frames.
+        FloydSteinberg,  // Error diffusion, best for photos and gradients.
+    };
+
+    inline const char* toString(Dither mode) {
+        switch (mode) {
+            case Dither::Ordered: return "ordered";
+            case Dither::FloydSteinberg: return "floyd";
+            default: return "threshold";
+        }
+    }
+
+    inline bool parseDither(const std::string& text, Dither& mode) {
+        for (Dither candidate : {Dither::Threshold, Dither::Ordered, Dither::FloydSteinberg}) {
+            if (text == toString(candidate)) {
+                mode = candidate;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    struct Options {
+        bool pageMajor{true};
+        bool rle{true};
+        bool bin{false};  // Raw data in a .bin next to the header, pulled in with KMK_INCBIN.
+        Dither dither{Dither::Threshold};  // Used for greyscale inputs (PGM, GIMP headers).
+        std::size_t fontCellWidth{0};  // Non-zero makes the input a glyph sheet for a kmk::Font atlas.
+        std::size_t fontCellHeight{0};
+        std::size_t fontFirst{32};
+
+        bool isFont() const { return fontCellWidth != 0; }
+
+        std::string toString() const {
+            return std::string("layout=") + (pageMajor ? "page" : "row") + " rle=" + (rle ? "1" : "0") + " bin=" + (bin ? "1" : "0")
+                + " dither=" + generator::toString(dither)
+                + " font=" + std::to_string(fontCellWidth) + "x" + std::to_string(fontCellHeight) + " first=" + std::to_string(fontFirst);
+        }
+    };
+
+    /**
+     * One entry in an asset manifest: generated namespace images::<name>, input image and output header.
+    */
+    struct Asset {
+        std::string name;
+        std::filesystem::path input;
+        std::filesystem::path output;
+        Options options;
+    };
+
+    /**
+     * 64-bit FNV-1a. Not cryptographic, only used to notice that inputs or options changed.
+    */
+    class Hash {
+    public:
+        void add(const void* data, std::size_t size) {
+            const auto* bytes = static_cast<const uint8_t*>(data);
+            for (std::size_t i = 0; i < size; ++i) {
+                value_ = (value_ ^ bytes[i]) * 0x100000001b3ull;
+            }
+        }
+
+        void add(const std::string& text) { add(text.data(), text.size()); }
+
+        std::string hex() const {
+            char text[17];
+            std::snprintf(text, sizeof(text), "%016llx", static_cast<unsigned long long>(value_));
+            return text;
+        }
+
+    private:
+        uint64_t value_{0xcbf29ce484222325ull};
+    };
+
+    inline std::vector<uint8_t> readFile(const std::filesystem::path& path) {
+        std::ifstream in(path, std::ios::binary);
+        if (!in) {
+            throw std::runtime_error("Cannot open " + path.string());
+        }
+        return std::vector<uint8_t>(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    }
+
+    /**
+     * Reads a PBM image, both the plain (P1) and the raw (P4) variant. In PBM 1 is black, here it means a lit pixel,
+     * so draw the art in black on white.
+    */
+    inline Image parsePbm(const std::vector<uint8_t>& data, const std::string& name) {
+        std::size_t pos = 0;
+        auto skipSpaceAndComments = [&]() {
+            while (pos < data.size()) {
+                if (data[pos] == '#') {
+                    while (pos < data.size() && data[pos] != '\n') {
+                        ++pos;
+                    }
+                } else if (std::isspace(data[pos])) {
+                    ++pos;
+                } else {
+                    break;
+                }
+            }
+        };
+        auto readNumber = [&]() {
+            skipSpaceAndComments();
+            std::size_t value = 0;
+            bool any = false;
+            while (pos < data.size() && std::isdigit(data[pos])) {
+                value = value * 10 + (data[pos++] - '0');
+                any = true;
+            }
+            if (!any) {
+                throw std::runtime_error(name + ": malformed PBM header");
+            }
+            return value;
+        };
+
+        if (data.size() < 2 || data[0] != 'P' || (data[1] != '1' && data[1] != '4')) {
+            throw std::runtime_error(name + ": not a PBM (P1/P4) file");
+        }
+        const bool raw = data[1] == '4';
+        pos = 2;
+
+        Image image;
+        image.width = readNumber();
+        image.height = readNumber();
+        image.pixels.resize(image.width * image.height);
+
+        if (raw) {
+            ++pos;  // Exactly one whitespace character before the raster.
+            const std::size_t rowBytes = (image.width + 7) / 8;
+            if (data.size() < pos + rowBytes * image.height) {
+                throw std::runtime_error(name + ": truncated PBM raster");
+            }
+            for (std::size_t y = 0; y < image.height; ++y) {
+                for (std::size_t x = 0; x < image.width; ++x) {
+                    image.pixels[y * image.width + x] = (data[pos + y * rowBytes + x / 8] >> (7 - x % 8)) & 1;
+                }
+            }
+        } else {
+            for (auto& pixel : image.pixels) {
+                skipSpaceAndComments();
+                if (pos >= data.size()) {
+                    throw std::runtime_error(name + ": truncated PBM raster");
+                }
+                pixel = data[pos++] == '1';
+            }
+        }
+        return image;
+    }
+
+    /**
+     * Reads "name input output [layout=page|row] [rle=1|0] [bin=0|1] [dither=threshold|ordered|floyd]
+     * [font=<cell width>x<cell height> [first=<first character>]]" lines, '#' starts a comment.
+     * Relative paths are relative to the directory the generator runs in (the project directory).
+    */
+    inline std::vector<Asset> readManifest(const std::filesystem::path& path) {
+        std::ifstream in(path);
+        if (!in) {
+            throw std::runtime_error("Cannot open manifest " + path.string());
+        }
+
+        std::vector<Asset> assets;
+        std::string line;
+        int lineNumber = 0;
+        while (std::getline(in, line)) {
+            ++lineNumber;
+            line = line.substr(0, line.find('#'));
+            std::istringstream fields(line);
+            Asset asset;
+            std::string input, output;
+            if (!(fields >> asset.name)) {
+                continue;
+            }
+            if (!(fields >> input >> output)) {
+                throw std::runtime_error(path.string() + ":" + std::to_string(lineNumber) + ": expected name, input and output");
+            }
+            asset.input = input;
+            asset.output = output;
+
+            std::string option;
+            while (fields >> option) {
+                if (option == "layout=page") {
+                    asset.options.pageMajor = true;
+                } else if (option == "layout=row") {
+                    asset.options.pageMajor = false;
+                } else if (option == "rle=1") {
+                    asset.options.rle = true;
+                } else if (option == "rle=0") {
+                    asset.options.rle = false;
+                } else if (option == "bin=1") {
+                    asset.options.bin = true;
+                } else if (option == "bin=0") {
+                    asset.options.bin = false;
+                } else if (option.rfind("dither=", 0) == 0 && parseDither(option.substr(7), asset.options.dither)) {
+                    // Parsed into asset.options.dither.
+                } else if (option.rfind("font=", 0) == 0 && option.find('x') != std::string::npos) {
+                    asset.options.fontCellWidth = std::stoul(option.substr(5));
+                    asset.options.fontCellHeight = std::stoul(option.substr(option.find('x') + 1));
+                } else if (option.rfind("first=", 0) == 0) {
+                    asset.options.fontFirst = std::stoul(option.substr(6));
+                } else {
+                    throw std::runtime_error(path.string() + ":" + std::to_string(lineNumber) + ": unknown option " + option);
+                }
+            }
+            assets.push_back(asset);
+        }
+        return assets;
+    }
+
+    inline std::vector<uint8_t> pack(const Image& image, const Options& options) {
+        if (options.pageMajor) {
+            std::vector<uint8_t> packed(kmk::pageMajorSize(image.width, image.height));
+            kmk::packPageMajor(image.pixels.data(), image.width, image.height, packed.data());
+            return packed;
+        }
+        std::vector<uint8_t> packed(kmk::rowMajorSize(image.width, image.height));
+        kmk::packRowMajor(image.pixels.data(), image.width, image.height, packed.data());
+        return packed;
+    }
+
+    /**
+     * Collects decoded bytes so the generator can check its own output before writing it.
+    */
+    struct VectorSink {
+        std::vector<uint8_t>& out;
+
+        void put(uint8_t value) { out.push_back(value); }
+        void fill(uint8_t value, std::size_t count) { out.insert(out.end(), count, value); }
+    };
+
+    inline std::vector<uint8_t> encodeRle(const std::vector<uint8_t>& packed) {
+        std::vector<uint8_t> rleData;
+        kmk::rle::encode(packed.data(), packed.size(), [&](uint8_t byte) { rleData.push_back(byte); });
+
+        // Round trip check, never write an asset the firmware decoder would get wrong.
+        std::vector<uint8_t> decoded;
+        kmk::rle::decode(rleData.data(), rleData.size(), VectorSink{decoded});
+        if (decoded != packed) {
+            throw std::runtime_error("RLE round trip does not match the packed bitmap");
+        }
+        return rleData;
+    }
+
+    /**
+     * Turns a file name into a C++ identifier for the generated namespace or constant.
+    */
+    inline std::string identifier(const std::string& text) {
+        std::string name;
+        for (char c : text) {
+            name += std::isalnum(static_cast<unsigned char>(c)) ? c : '_';
+        }
+        if (name.empty() || std::isdigit(static_cast<unsigned char>(name[0]))) {
+            name = "img_" + name;
+        }
+        return name;
+    }
+
+    inline std::string includeGuard(const std::filesystem::path& output) {
+        std::string guard;
+        for (char c : output.filename().string()) {
+            guard += std::isalnum(static_cast<unsigned char>(c)) ? static_cast<char>(std::toupper(static_cast<unsigned char>(c))) : '_';
+        }
+        return guard;
+    }
+
+    /**
+     * First line of every generated header, holds the hash of everything the output depends on.
+    */
+    inline std::string hashLine(const std::string& hash) {
+        return "// kmk-asset-hash: " + hash;
+    }
+
+    /**
+     * Appends data as rows of 16 hex bytes. The rows are fixed width, so the string is grown once up front.
+     * About 6 characters per byte instead of the 27 the old one-binary-literal-per-line format used.
+    */
+    inline void appendHexRows(std::string& out, const std::vector<uint8_t>& data, const std::string& indent) {
+        constexpr std::size_t bytesPerRow = 16;
+        constexpr char digits[] = "0123456789abcdef";
+
+        const std::size_t rows = (data.size() + bytesPerRow - 1) / bytesPerRow;
+        std::size_t pos = out.size();
+        out.resize(pos + rows * (indent.size() + 1) + data.size() * 6);
+
+        for (std::size_t i = 0; i < data.size(); ++i) {
+            if (i % bytesPerRow == 0) {
+                out.replace(pos, indent.size(), indent);
+                pos += indent.size();
+            }
+            out[pos++] = '0';
+            out[pos++] = 'x';
+            out[pos++] = digits[data[i] >> 4];
+            out[pos++] = digits[data[i] & 0x0F];
+            out[pos++] = ',';
+            if (i % bytesPerRow == bytesPerRow - 1 || i + 1 == data.size()) {
+                out[pos++] = '\n';
+            } else {
+                out[pos++] = ' ';
+            }
+        }
+        out.resize(pos);
+    }
+
+    /**
+     * Path of the .bin written next to the header when Options::bin is set.
+    */
+    inline std::filesystem::path binPath(const Asset& asset) {
+        return std::filesystem::path(asset.output).replace_extension(".bin");
+    }
+
+    struct Rendered {
+        std::string header;
+        std::vector<uint8_t> bin;  // Empty unless Options::bin is set.
+    };
+
+    inline Rendered renderHeader(const Asset& asset, const Image& image, const std::string& hash) {
+        const std::vector<uint8_t> packed = pack(image, asset.options);
+        const std::vector<uint8_t> data = asset.options.rle ? encodeRle(packed) : packed;
+        const std::string guard = includeGuard(asset.output);
+        const std::string arrayName = asset.options.rle ? "rle" : "bitmap";
+        const char* layout = asset.options.pageMajor ? "SSD1306 page-major" : "Row-major, MSB first";
+
+        Rendered rendered;
+        std::string& out = rendered.header;
+        out.reserve(1024 + data.size() * 6 + data.size() / 16 * 12);
+
+        // Hard-coded template. A better option would be to create a template file for this using XML or JSON.
+        out += hashLine(hash) + "\n";
+        out += "// Generated by src/generator.cpp from " + asset.input.generic_string() + ", do not edit.\n";
+        out += "#ifndef " + guard + "\n";
+        out += "#define " + guard + "\n\n";
+        if (asset.options.bin) {
+            out += "#include <kmk/incbin.h>\n\n";
+            out += "// Include from one source file only, the data is defined by the assembler.\n";
+            out += "KMK_INCBIN(images_" + asset.name + "_" + arrayName + ", \"" + binPath(asset).generic_string() + "\");\n\n";
+        } else {
+            out += "#include <avr/pgmspace.h>\n\n";
+        }
+        out += "namespace images {\n";
+        out += "    namespace " + asset.name + " {\n";
+        out += "        constexpr uint8_t width{" + std::to_string(image.width) + "};\n\n";
+        out += "        constexpr uint8_t height{" + std::to_string(image.height) + "};\n\n";
+        out += std::string("        constexpr bool pageMajor{") + (asset.options.pageMajor ? "true" : "false") + "};\n\n";
+        if (asset.options.rle) {
+            out += std::string("        // ") + layout + " bitmap (" + std::to_string(packed.size()) + " bytes) run-length encoded with kmk/rle.h.\n";
+        } else {
+            out += std::string("        // ") + layout + " bitmap.\n";
+        }
+
+        if (asset.options.bin) {
+            out += "        constexpr std::size_t " + arrayName + "Size{" + std::to_string(data.size()) + "};\n";
+            out += "        static const uint8_t* const " + arrayName + "{images_" + asset.name + "_" + arrayName + "};\n\n";
+            rendered.bin = data;
+        } else {
+            out += "        static const uint8_t PROGMEM " + arrayName + "[] = {\n";
+            appendHexRows(out, data, "            ");
+            out += "        };\n\n";
+        }
+        out += "    };\n\n";
+        out += "};\n\n";
+        out += "#endif // " + guard + "\n";
+        return rendered;
+    }
+
+    /**
+     * True when the output already carries this hash, so generating it again would give the same file.
+    */
+    inline bool isUpToDate(const std::filesystem::path& output, const std::string& hash) {
+        std::ifstream in(output);
+        std::string firstLine;
+        return in && std::getline(in, firstLine) && firstLine == hashLine(hash);
+    }
+
+    /**
+     * Only touches the file when the content differs, so its mtime (and the firmware build) is left alone otherwise.
+     * The content is written with a single call.
+    */
+    inline bool writeIfChanged(const std::filesystem::path& output, const void* content, std::size_t size) {
+        const auto* bytes = static_cast<const uint8_t*>(content);
+        std::error_code error;
+        if (std::filesystem::exists(output, error)) {
+            const std::vector<uint8_t> existing = readFile(output);
+            if (existing.size() == size && std::equal(existing.begin(), existing.end(), bytes)) {
+                return false;
+            }
+        }
+
+        std::ofstream out(output, std::ios::binary);
+        if (!out) {
+            throw std::runtime_error("Error opening " + output.string() + " for writing");
+        }
+        out.write(reinterpret_cast<const char*>(bytes), static_cast<std::streamsize>(size));
+        return true;
+    }
+
+    inline bool writeIfChanged(const std::filesystem::path& output, const std::string& content) {
+        return writeIfChanged(output, content.data(), content.size());
+    }
+}
+
+#endif // GENERATOR_ASSET_H
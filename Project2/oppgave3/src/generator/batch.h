@@ -0,0 +1,42 @@
+#ifndef GENERATOR_BATCH_H
+#define GENERATOR_BATCH_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace generator
+{
+    /**
+     * Runs job(i) for i in [0, count) on a small pool of threads. Each worker takes the next index from a shared
+     * counter, so a few large images do not leave the other threads idle. job must be safe to run concurrently
+     * for different indices; with threads == 0 the hardware concurrency is used.
+    */
+    template<typename Job>
+    void parallelFor(std::size_t count, unsigned threads, Job job) {
+        if (threads == 0) {
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+        threads = static_cast<unsigned>(std::min<std::size_t>(threads, count));
+
+        std::atomic<std::size_t> next{0};
+        auto worker = [&]() {
+            for (std::size_t i = next++; i < count; i = next++) {
+                job(i);
+            }
+        };
+
+        std::vector<std::thread> pool;
+        for (unsigned t = 1; t < threads; ++t) {
+            pool.emplace_back(worker);
+        }
+        worker();  // The calling thread works too.
+        for (auto& thread : pool) {
+            thread.join();
+        }
+    }
+}
+
+#endif // GENERATOR_BATCH_H
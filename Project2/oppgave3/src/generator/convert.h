@@ -0,0 +1,272 @@
+#ifndef GENERATOR_CONVERT_H
+#define GENERATOR_CONVERT_H
+
+#include <array>
+#include <cctype>
+#include <cstdint>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "asset.h"
+
+namespace generator
+{
+    /**
+     * 8-bit greyscale, 0 is black (pixel off) and 255 is white (pixel lit), like the OLED.
+    */
+    struct GreyImage {
+        std::size_t width{0};
+        std::size_t height{0};
+        std::vector<uint8_t> grey;
+    };
+
+    /**
+     * Reads a PGM image, plain (P2) or raw (P5). Maxval other than 255 is rescaled, 16-bit samples use the high byte.
+    */
+    inline GreyImage parsePgm(const std::vector<uint8_t>& data, const std::string& name) {
+        std::size_t pos = 2;
+        auto readNumber = [&]() {
+            while (pos < data.size() && (std::isspace(data[pos]) || data[pos] == '#')) {
+                if (data[pos] == '#') {
+                    while (pos < data.size() && data[pos] != '\n') {
+                        ++pos;
+                    }
+                } else {
+                    ++pos;
+                }
+            }
+            std::size_t value = 0;
+            bool any = false;
+            while (pos < data.size() && std::isdigit(data[pos])) {
+                value = value * 10 + (data[pos++] - '0');
+                any = true;
+            }
+            if (!any) {
+                throw std::runtime_error(name + ": malformed PGM");
+            }
+            return value;
+        };
+
+        if (data.size() < 2 || data[0] != 'P' || (data[1] != '2' && data[1] != '5')) {
+            throw std::runtime_error(name + ": not a PGM (P2/P5) file");
+        }
+        const bool raw = data[1] == '5';
+
+        GreyImage image;
+        image.width = readNumber();
+        image.height = readNumber();
+        const std::size_t maxValue = readNumber();
+        if (maxValue == 0 || maxValue > 65535) {
+            throw std::runtime_error(name + ": invalid PGM maxval");
+        }
+        image.grey.resize(image.width * image.height);
+
+        const std::size_t sampleBytes = maxValue > 255 ? 2 : 1;
+        if (raw) {
+            ++pos;  // Exactly one whitespace character before the raster.
+            if (data.size() < pos + image.grey.size() * sampleBytes) {
+                throw std::runtime_error(name + ": truncated PGM raster");
+            }
+        }
+        for (auto& pixel : image.grey) {
+            std::size_t value;
+            if (raw) {
+                value = sampleBytes == 2 ? (data[pos] << 8 | data[pos + 1]) : data[pos];
+                pos += sampleBytes;
+            } else {
+                value = readNumber();
+            }
+            pixel = static_cast<uint8_t>(value * 255 / maxValue);
+        }
+        return image;
+    }
+
+    /**
+     * Reads an INDEXED "C source header" export from GIMP (like include/mas245_logo_gimp_export.h) as text,
+     * looking each header_data index up in header_data_cmap. Other GIMP header formats are rejected.
+    */
+    inline GreyImage parseGimpHeader(const std::vector<uint8_t>& data, const std::string& name) {
+        const std::string text(data.begin(), data.end());
+
+        auto numberAfter = [&](const std::string& key) {
+            const std::size_t at = text.find(key);
+            if (at == std::string::npos) {
+                throw std::runtime_error(name + ": missing " + key);
+            }
+            return std::stoul(text.substr(text.find_first_of("0123456789", at + key.size())));
+        };
+        auto numbersIn = [&](const std::string& key) {
+            const std::size_t at = text.find(key);
+            if (at == std::string::npos) {
+                throw std::runtime_error(name + ": missing " + key + ", only INDEXED GIMP exports are supported");
+            }
+            const std::size_t begin = text.find('{', at);
+            const std::size_t end = text.find("};", begin);
+            std::vector<uint8_t> numbers;
+            std::size_t value = 0;
+            bool inNumber = false;
+            for (std::size_t i = begin; i < end; ++i) {
+                if (std::isdigit(static_cast<unsigned char>(text[i]))) {
+                    value = value * 10 + (text[i] - '0');
+                    inNumber = true;
+                } else if (inNumber) {
+                    numbers.push_back(static_cast<uint8_t>(value));
+                    value = 0;
+                    inNumber = false;
+                }
+            }
+            return numbers;
+        };
+
+        GreyImage image;
+        image.width = numberAfter("width =");
+        image.height = numberAfter("height =");
+        const std::vector<uint8_t> cmap = numbersIn("header_data_cmap[256][3]");
+        const std::vector<uint8_t> indices = numbersIn("header_data[]");
+        if (cmap.size() != 256 * 3 || indices.size() != image.width * image.height) {
+            throw std::runtime_error(name + ": unexpected GIMP header contents");
+        }
+
+        image.grey.resize(indices.size());
+        for (std::size_t i = 0; i < indices.size(); ++i) {
+            const uint8_t* rgb = &cmap[indices[i] * 3];
+            image.grey[i] = static_cast<uint8_t>((rgb[0] * 77u + rgb[1] * 150u + rgb[2] * 29u) >> 8);  // Rec. 601 luma.
+        }
+        return image;
+    }
+
+    namespace detail
+    {
+        /**
+         * 8x8 Bayer matrix scaled to thresholds in 0..255.
+        */
+        constexpr std::array<std::array<uint8_t, 8>, 8> bayerThresholds() {
+            constexpr uint8_t bayer[8][8] = {
+                { 0, 32,  8, 40,  2, 34, 10, 42},
+                {48, 16, 56, 24, 50, 18, 58, 26},
+                {12, 44,  4, 36, 14, 46,  6, 38},
+                {60, 28, 52, 20, 62, 30, 54, 22},
+                { 3, 35, 11, 43,  1, 33,  9, 41},
+                {51, 19, 59, 27, 49, 17, 57, 25},
+                {15, 47,  7, 39, 13, 45,  5, 37},
+                {63, 31, 55, 23, 61, 29, 53, 21},
+            };
+            std::array<std::array<uint8_t, 8>, 8> thresholds{};
+            for (std::size_t y = 0; y < 8; ++y) {
+                for (std::size_t x = 0; x < 8; ++x) {
+                    thresholds[y][x] = static_cast<uint8_t>(bayer[y][x] * 4 + 2);
+                }
+            }
+            return thresholds;
+        }
+
+        /**
+         * Row kernels. Plain loops over contiguous bytes with no branches, so the compiler vectorizes
+         * them (-O2 -ftree-vectorize / -O3).
+        */
+        inline void thresholdRow(const uint8_t* grey, uint8_t* out, std::size_t width, uint8_t level) {
+            for (std::size_t x = 0; x < width; ++x) {
+                out[x] = grey[x] >= level;
+            }
+        }
+
+        inline void orderedRow(const uint8_t* grey, uint8_t* out, std::size_t width, const uint8_t* thresholdRow8) {
+            // Widen the 8 thresholds to a full row once, then it is the same kernel as plain thresholding.
+            uint8_t row[64];
+            for (std::size_t x = 0; x < sizeof(row); ++x) {
+                row[x] = thresholdRow8[x % 8];
+            }
+            for (std::size_t start = 0; start < width; start += sizeof(row)) {
+                const std::size_t count = width - start < sizeof(row) ? width - start : sizeof(row);
+                for (std::size_t x = 0; x < count; ++x) {
+                    out[start + x] = grey[start + x] > row[x];
+                }
+            }
+        }
+
+        /**
+         * Floyd-Steinberg on one row. current holds this row plus the error pushed down from the row above,
+         * next collects the error for the row below. Error diffusion runs left to right, so this one does
+         * not vectorize; batches get their speed from converting many images in parallel instead.
+        */
+        inline void floydSteinbergRow(int16_t* current, int16_t* next, uint8_t* out, std::size_t width) {
+            for (std::size_t x = 0; x < width; ++x) {
+                const int16_t value = current[x];
+                const bool lit = value >= 128;
+                out[x] = lit;
+                const int16_t error = static_cast<int16_t>(value - (lit ? 255 : 0));
+                if (x + 1 < width) {
+                    current[x + 1] = static_cast<int16_t>(current[x + 1] + error * 7 / 16);
+                    next[x + 1] = static_cast<int16_t>(next[x + 1] + error / 16);
+                }
+                if (x > 0) {
+                    next[x - 1] = static_cast<int16_t>(next[x - 1] + error * 3 / 16);
+                }
+                next[x] = static_cast<int16_t>(next[x] + error * 5 / 16);
+            }
+        }
+    }
+
+    /**
+     * Converts greyscale to one byte per pixel (1 = lit) with the selected dither.
+    */
+    inline Image dither(const GreyImage& source, Dither mode) {
+        Image image;
+        image.width = source.width;
+        image.height = source.height;
+        image.pixels.resize(source.grey.size());
+
+        const std::size_t w = source.width;
+        switch (mode) {
+            case Dither::Threshold:
+                for (std::size_t y = 0; y < source.height; ++y) {
+                    detail::thresholdRow(&source.grey[y * w], &image.pixels[y * w], w, 128);
+                }
+                break;
+
+            case Dither::Ordered: {
+                constexpr auto thresholds = detail::bayerThresholds();
+                for (std::size_t y = 0; y < source.height; ++y) {
+                    detail::orderedRow(&source.grey[y * w], &image.pixels[y * w], w, thresholds[y % 8].data());
+                }
+                break;
+            }
+
+            case Dither::FloydSteinberg: {
+                std::vector<int16_t> current(w), next(w);
+                for (std::size_t y = 0; y < source.height; ++y) {
+                    for (std::size_t x = 0; x < w; ++x) {
+                        current[x] = static_cast<int16_t>(source.grey[y * w + x] + next[x]);
+                        next[x] = 0;
+                    }
+                    detail::floydSteinbergRow(current.data(), next.data(), &image.pixels[y * w], w);
+                }
+                break;
+            }
+        }
+        return image;
+    }
+
+    /**
+     * Loads PBM (.pbm), PGM (.pgm) or INDEXED GIMP header (.h) images. PBM is already 1-bit and is not dithered.
+    */
+    inline Image loadImageFile(const std::filesystem::path& path, const std::vector<uint8_t>& data, Dither mode) {
+        const std::string extension = path.extension().string();
+        if (extension == ".pgm") {
+            return dither(parsePgm(data, path.string()), mode);
+        }
+        if (extension == ".h") {
+            return dither(parseGimpHeader(data, path.string()), mode);
+        }
+        return parsePbm(data, path.string());
+    }
+
+    inline bool isImageFile(const std::filesystem::path& path) {
+        const std::string extension = path.extension().string();
+        return extension == ".pbm" || extension == ".pgm" || extension == ".h";
+    }
+}
+
+#endif // GENERATOR_CONVERT_H
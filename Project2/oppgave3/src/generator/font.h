@@ -0,0 +1,107 @@
+#ifndef GENERATOR_FONT_H
+#define GENERATOR_FONT_H
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <kmk/image.h>
+
+#include "asset.h"
+
+namespace generator
+{
+    /**
+     * Cuts a glyph sheet (cells of Options::fontCellWidth x fontCellHeight, left to right, top to bottom, starting at
+     * character Options::fontFirst) into a page-aligned kmk::Font atlas. Empty columns on both sides of a glyph are
+     * trimmed so the font is proportional; an empty cell (space) gets half the cell width.
+    */
+    inline Rendered renderFont(const Asset& asset, const Image& sheet, const std::string& hash) {
+        const std::size_t cellWidth = asset.options.fontCellWidth;
+        const std::size_t cellHeight = asset.options.fontCellHeight;
+        if (cellWidth == 0 || cellHeight == 0 || sheet.width % cellWidth != 0 || sheet.height % cellHeight != 0) {
+            throw std::runtime_error(asset.name + ": sheet size is not a multiple of the font cell size");
+        }
+        const std::size_t columnsPerRow = sheet.width / cellWidth;
+        const std::size_t count = columnsPerRow * (sheet.height / cellHeight);
+        const std::size_t pages = (cellHeight + 7) / 8;
+        if (asset.options.fontFirst + count > 256) {
+            throw std::runtime_error(asset.name + ": more glyphs than characters");
+        }
+
+        std::vector<uint8_t> columns;
+        std::string glyphs;
+        for (std::size_t i = 0; i < count; ++i) {
+            const std::size_t cellX = (i % columnsPerRow) * cellWidth;
+            const std::size_t cellY = (i / columnsPerRow) * cellHeight;
+            auto lit = [&](std::size_t x, std::size_t y) { return sheet.pixels[(cellY + y) * sheet.width + cellX + x] != 0; };
+
+            std::size_t left = cellWidth;
+            std::size_t right = 0;
+            for (std::size_t x = 0; x < cellWidth; ++x) {
+                for (std::size_t y = 0; y < cellHeight; ++y) {
+                    if (lit(x, y)) {
+                        left = std::min(left, x);
+                        right = std::max(right, x + 1);
+                    }
+                }
+            }
+            if (left >= right) {
+                left = 0;
+                right = (cellWidth + 1) / 2;
+            }
+
+            Image glyph;
+            glyph.width = right - left;
+            glyph.height = cellHeight;
+            for (std::size_t y = 0; y < cellHeight; ++y) {
+                for (std::size_t x = left; x < right; ++x) {
+                    glyph.pixels.push_back(lit(x, y) ? 1 : 0);
+                }
+            }
+
+            if (columns.size() > 0xFFFF) {
+                throw std::runtime_error(asset.name + ": atlas too large for 16 bit offsets");
+            }
+            const char c = static_cast<char>(asset.options.fontFirst + i);
+            glyphs += "            {" + std::to_string(columns.size()) + ", " + std::to_string(glyph.width) + "},";
+            if (c >= 0x20 && c < 0x7F) {
+                glyphs += std::string("  // '") + (c == '\\' ? "\\\\" : std::string(1, c)) + "'";
+            }
+            glyphs += "\n";
+
+            const std::vector<uint8_t> packed = pack(glyph, Options{});
+            columns.insert(columns.end(), packed.begin(), packed.end());
+        }
+
+        const std::string guard = includeGuard(asset.output);
+        Rendered rendered;
+        std::string& out = rendered.header;
+        out.reserve(4096 + columns.size() * 6);
+
+        out += hashLine(hash) + "\n";
+        out += "// Generated by src/generator.cpp from " + asset.input.generic_string() + ", do not edit.\n";
+        out += "#ifndef " + guard + "\n";
+        out += "#define " + guard + "\n\n";
+        out += "#include <kmk/text.h>\n\n";
+        out += "namespace fonts {\n";
+        out += "    namespace " + asset.name + " {\n";
+        out += "        // Page-major glyph columns, " + std::to_string(pages) + " page(s) per glyph.\n";
+        out += "        static constexpr uint8_t PROGMEM columns[] = {\n";
+        appendHexRows(out, columns, "            ");
+        out += "        };\n\n";
+        out += "        // Offset into columns and width of every glyph.\n";
+        out += "        constexpr kmk::Glyph glyphs[] = {\n";
+        out += glyphs;
+        out += "        };\n\n";
+        out += "        constexpr kmk::Font font{columns, glyphs, " + std::to_string(asset.options.fontFirst) + ", "
+            + std::to_string(count) + ", " + std::to_string(pages) + ", 1, " + std::to_string(cellHeight) + "};\n";
+        out += "    };\n\n";
+        out += "};\n\n";
+        out += "#endif // " + guard + "\n";
+        return rendered;
+    }
+}
+
+#endif // GENERATOR_FONT_H
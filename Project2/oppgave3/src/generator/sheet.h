@@ -0,0 +1,160 @@
+#ifndef GENERATOR_SHEET_H
+#define GENERATOR_SHEET_H
+
+#include <algorithm>
+#include <cstdint>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <kmk/rle.h>
+
+#include "asset.h"
+#include "convert.h"
+
+namespace generator
+{
+    /**
+     * A sheet asset has a comma separated list of inputs, or a single directory. Each input is one sprite named
+     * after the file or directory; a directory is an animation with its image files (sorted by name) as frames.
+    */
+    struct SheetSprite {
+        std::string name;
+        std::vector<std::filesystem::path> frames;
+    };
+
+    inline bool isSheet(const Asset& asset) {
+        const std::string input = asset.input.string();
+        std::error_code error;
+        return input.find(',') != std::string::npos || std::filesystem::is_directory(asset.input, error);
+    }
+
+    inline std::vector<SheetSprite> sheetSprites(const Asset& asset) {
+        std::vector<SheetSprite> sprites;
+        const std::string inputs = asset.input.string();
+        std::size_t start = 0;
+        while (start <= inputs.size()) {
+            const std::size_t comma = std::min(inputs.find(',', start), inputs.size());
+            const std::filesystem::path input(inputs.substr(start, comma - start));
+            start = comma + 1;
+            if (input.empty()) {
+                continue;
+            }
+
+            SheetSprite sprite;
+            if (std::filesystem::is_directory(input)) {
+                const std::filesystem::path dir = input.filename().empty() ? input.parent_path() : input;  // "res/spin/"
+                sprite.name = identifier(dir.filename().string());
+                for (const auto& entry : std::filesystem::directory_iterator(input)) {
+                    if (entry.is_regular_file() && isImageFile(entry.path())) {
+                        sprite.frames.push_back(entry.path());
+                    }
+                }
+                std::sort(sprite.frames.begin(), sprite.frames.end());
+            } else {
+                sprite.name = identifier(input.stem().string());
+                sprite.frames.push_back(input);
+            }
+
+            if (sprite.frames.empty()) {
+                throw std::runtime_error(input.string() + ": no frames");
+            }
+            sprites.push_back(sprite);
+        }
+        return sprites;
+    }
+
+    /**
+     * The streams kmk::AnimationPlayer plays: the first frame, then the XOR delta to each next frame and back to
+     * the first. Deltas are mostly zero where little moves, and those runs RLE down to a couple of bytes.
+    */
+    inline std::vector<uint8_t> animationStreams(const std::vector<Image>& frames) {
+        std::vector<std::vector<uint8_t>> packed;
+        for (const auto& frame : frames) {
+            packed.push_back(pack(frame, Options{}));
+        }
+
+        std::vector<uint8_t> streams;
+        auto appendStream = [&](const std::vector<uint8_t>& bytes) {
+            const std::vector<uint8_t> encoded = encodeRle(bytes);
+            if (encoded.size() > 0xFFFF) {
+                throw std::runtime_error("Frame too large for a 16 bit stream length");
+            }
+            streams.push_back(static_cast<uint8_t>(encoded.size() & 0xFF));
+            streams.push_back(static_cast<uint8_t>(encoded.size() >> 8));
+            streams.insert(streams.end(), encoded.begin(), encoded.end());
+        };
+
+        appendStream(packed.front());
+        for (std::size_t i = 0; i < packed.size(); ++i) {
+            const auto& from = packed[i];
+            const auto& to = packed[(i + 1) % packed.size()];
+            std::vector<uint8_t> delta(from.size());
+            for (std::size_t k = 0; k < delta.size(); ++k) {
+                delta[k] = from[k] ^ to[k];
+            }
+            appendStream(delta);
+        }
+        return streams;
+    }
+
+    struct LoadedSprite {
+        std::string name;
+        std::vector<Image> frames;
+    };
+
+    inline Rendered renderSheet(const Asset& asset, const std::vector<LoadedSprite>& sprites, const std::string& hash) {
+        const std::string guard = includeGuard(asset.output);
+
+        std::vector<uint8_t> data;
+        std::string table;
+        std::string indices;
+        for (std::size_t i = 0; i < sprites.size(); ++i) {
+            const auto& sprite = sprites[i];
+            const Image& first = sprite.frames.front();
+            for (const auto& frame : sprite.frames) {
+                if (frame.width != first.width || frame.height != first.height) {
+                    throw std::runtime_error(sprite.name + ": all frames must have the same size");
+                }
+            }
+            if (first.width > 255 || first.height > 255 || sprite.frames.size() > 255 || data.size() > 0xFFFF) {
+                throw std::runtime_error(sprite.name + ": does not fit the SpriteInfo table");
+            }
+
+            table += "            {" + std::to_string(first.width) + ", " + std::to_string(first.height) + ", "
+                + std::to_string(data.size()) + ", " + std::to_string(sprite.frames.size()) + "},  // " + sprite.name + "\n";
+            indices += "        constexpr uint8_t " + sprite.name + "{" + std::to_string(i) + "};\n";
+
+            const std::vector<uint8_t> streams = animationStreams(sprite.frames);
+            data.insert(data.end(), streams.begin(), streams.end());
+        }
+
+        Rendered rendered;
+        std::string& out = rendered.header;
+        out.reserve(2048 + data.size() * 6 + data.size() / 16 * 12);
+
+        out += hashLine(hash) + "\n";
+        out += "// Generated by src/generator.cpp from " + asset.input.generic_string() + ", do not edit.\n";
+        out += "#ifndef " + guard + "\n";
+        out += "#define " + guard + "\n\n";
+        out += "#include <kmk/sprite.h>\n\n";
+        out += "namespace images {\n";
+        out += "    namespace " + asset.name + " {\n";
+        out += "        // Sprite indices into the table below.\n";
+        out += indices + "\n";
+        out += "        // Width, height, offset into data and frame count. Frames are page-major, see kmk::SpriteInfo.\n";
+        out += "        constexpr kmk::SpriteInfo sprites[] = {\n";
+        out += table;
+        out += "        };\n\n";
+        out += "        static const uint8_t PROGMEM data[] = {\n";
+        appendHexRows(out, data, "            ");
+        out += "        };\n\n";
+        out += "    };\n\n";
+        out += "};\n\n";
+        out += "#endif // " + guard + "\n";
+        return rendered;
+    }
+}
+
+#endif // GENERATOR_SHEET_H
@@ -0,0 +1,300 @@
+// Benchmark and verification for the image pipeline in ../lib/kmk and src/generator.
+// Build and run from this directory with: pio run -e generator_bench && .pio/build/generator_bench/program
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+#include <kmk/image.h>
+#include <kmk/rle.h>
+#include <kmk/ssd1306_buffer.h>
+
+#include "generator/asset.h"
+#include "generator/convert.h"
+#include "mas245_splash.h"
+
+namespace
+{
+    /**
+     * Straightforward per-pixel versions of the packers, written for clarity rather than speed.
+     * Everything the pipeline produces is checked against these.
+    */
+    namespace reference
+    {
+        std::vector<uint8_t> rowMajor(const generator::Image& image) {
+            const std::size_t byteWidth = (image.width + 7) / 8;
+            std::vector<uint8_t> out(byteWidth * image.height, 0);
+            for (std::size_t y = 0; y < image.height; ++y) {
+                for (std::size_t x = 0; x < image.width; ++x) {
+                    const bool lit = image.pixels[y * image.width + x] != 0;
+                    out[y * byteWidth + x / 8] = static_cast<uint8_t>(out[y * byteWidth + x / 8] | (lit ? 0x80 >> (x % 8) : 0));
+                }
+            }
+            return out;
+        }
+
+        std::vector<uint8_t> pageMajor(const generator::Image& image) {
+            const std::size_t pages = (image.height + 7) / 8;
+            std::vector<uint8_t> out(image.width * pages, 0);
+            for (std::size_t page = 0; page < pages; ++page) {
+                for (std::size_t x = 0; x < image.width; ++x) {
+                    uint8_t byte = 0;
+                    for (std::size_t bit = 0; bit < 8; ++bit) {
+                        const std::size_t y = page * 8 + bit;
+                        if (y < image.height && image.pixels[y * image.width + x]) {
+                            byte = static_cast<uint8_t>(byte | (1 << bit));
+                        }
+                    }
+                    out[page * image.width + x] = byte;
+                }
+            }
+            return out;
+        }
+
+        std::vector<uint8_t> rleDecode(const std::vector<uint8_t>& encoded) {
+            std::vector<uint8_t> out;
+            for (std::size_t i = 0; i < encoded.size();) {
+                const uint8_t control = encoded[i++];
+                if (control < 0x80) {
+                    out.insert(out.end(), encoded.begin() + i, encoded.begin() + i + control + 1);
+                    i += control + 1;
+                } else {
+                    out.insert(out.end(), control - 0x80 + kmk::rle::minRun, encoded[i++]);
+                }
+            }
+            return out;
+        }
+    }
+
+    /**
+     * Synthetic atlas: blank borders, solid blocks, noise and thin lines, roughly like a sheet of sprites.
+    */
+    generator::Image syntheticImage(std::size_t width, std::size_t height) {
+        generator::Image image{width, height, std::vector<uint8_t>(width * height)};
+        uint32_t seed = 245;
+        for (std::size_t y = 0; y < height; ++y) {
+            for (std::size_t x = 0; x < width; ++x) {
+                seed = seed * 1664525u + 1013904223u;
+                const std::size_t tileX = x % 64, tileY = y % 64;
+                uint8_t lit = 0;
+                if (tileX < 8 || tileY < 8) {
+                    lit = 0;
+                } else if (tileX < 24 && tileY < 24) {
+                    lit = 1;
+                } else if (tileY < 40) {
+                    lit = (seed >> 28) & 1;
+                } else {
+                    lit = (x + y) % 7 == 0;
+                }
+                image.pixels[y * width + x] = lit;
+            }
+        }
+        return image;
+    }
+
+    generator::GreyImage gradientImage(std::size_t width, std::size_t height) {
+        generator::GreyImage image{width, height, std::vector<uint8_t>(width * height)};
+        for (std::size_t y = 0; y < height; ++y) {
+            for (std::size_t x = 0; x < width; ++x) {
+                image.grey[y * width + x] = static_cast<uint8_t>((x * 255 / width + y * 3) & 0xFF);
+            }
+        }
+        return image;
+    }
+
+    struct Measurement {
+        std::string name;
+        double megabytesPerSecond;
+    };
+
+    /**
+     * Best of a number of runs, repeated until each run takes long enough to time reliably.
+    */
+    double measure(std::size_t inputBytes, const std::function<void()>& run) {
+        using clock = std::chrono::steady_clock;
+        std::size_t iterations = 1;
+        for (;;) {
+            const auto start = clock::now();
+            for (std::size_t i = 0; i < iterations; ++i) {
+                run();
+            }
+            if (clock::now() - start > std::chrono::milliseconds(20) || iterations > (1u << 24)) {
+                break;
+            }
+            iterations *= 2;
+        }
+
+        double best = 1e30;
+        for (int repeat = 0; repeat < 5; ++repeat) {
+            const auto start = clock::now();
+            for (std::size_t i = 0; i < iterations; ++i) {
+                run();
+            }
+            const double seconds = std::chrono::duration<double>(clock::now() - start).count() / iterations;
+            best = std::min(best, seconds);
+        }
+        return inputBytes / best / 1e6;
+    }
+
+    int failures = 0;
+
+    void verify(bool ok, const std::string& what) {
+        if (!ok) {
+            std::cerr << "FAIL: " << what << "\n";
+            ++failures;
+        }
+    }
+
+    volatile std::size_t sinkValue;  // Keeps the optimizer from dropping benchmarked work.
+}
+
+
+int main(int argc, char* argv[])
+{
+    std::string saveBaseline, checkBaseline;
+    double tolerance = 0.25;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg(argv[i]);
+        if (arg == "--save-baseline" && i + 1 < argc) {
+            saveBaseline = argv[++i];
+        } else if (arg == "--baseline" && i + 1 < argc) {
+            checkBaseline = argv[++i];
+        } else if (arg == "--tolerance" && i + 1 < argc) {
+            tolerance = std::stod(argv[++i]);
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--save-baseline <file>] [--baseline <file> [--tolerance 0.25]]\n";
+            return 1;
+        }
+    }
+
+    std::vector<Measurement> results;
+    auto record = [&](const std::string& name, double mbps) {
+        results.push_back({name, mbps});
+        std::printf("  %-36s %10.1f MB/s\n", name.c_str(), mbps);
+    };
+
+    // constexpr path: the firmware packs the logo at compile time (mas245_splash.h), the runtime packers must
+    // agree byte for byte on the export read from disk as the generator reads it.
+    std::cout << "constexpr vs runtime (128x64 logo)\n";
+    {
+        using namespace images::mas245splash;
+        constexpr auto pixels = kmk::to_array(gimp::header_data);
+        constexpr auto rowPacked = kmk::compressBinaryArray(pixels);
+        constexpr const auto& pagePacked = pages;
+        constexpr const auto& rlePacked = rle;
+
+        const std::filesystem::path exportPath{"include/mas245_logo_gimp_export.h"};
+        const generator::Image logo = generator::loadImageFile(exportPath, generator::readFile(exportPath),
+                                                               generator::Dither::Threshold);
+        verify(logo.width == width && logo.height == height
+                   && std::equal(pixels.begin(), pixels.end(), logo.pixels.begin(), logo.pixels.end(),
+                                 [](uint8_t index, uint8_t lit) { return (index != 0) == (lit != 0); }),
+               "the export's colours light exactly the pixels the firmware takes as lit (index != 0)");
+        std::vector<uint8_t> runtimeRow(kmk::rowMajorSize(width, height));
+        std::vector<uint8_t> runtimePage(kmk::pageMajorSize(width, height));
+        kmk::packRowMajor(logo.pixels.data(), width, height, runtimeRow.data());
+        kmk::packPageMajor(logo.pixels.data(), width, height, runtimePage.data());
+
+        verify(std::equal(rowPacked.begin(), rowPacked.end(), runtimeRow.begin()), "constexpr compressBinaryArray == packRowMajor");
+        verify(std::equal(pagePacked.begin(), pagePacked.end(), runtimePage.begin()), "constexpr toPageMajor == packPageMajor");
+        verify(runtimeRow == reference::rowMajor(logo), "packRowMajor == reference");
+        verify(runtimePage == reference::pageMajor(logo), "packPageMajor == reference");
+        verify(reference::rleDecode(std::vector<uint8_t>(rlePacked.begin(), rlePacked.end())) == runtimePage,
+               "constexpr encodeArray decodes to the page-major logo");
+
+        // compressBinaryArray run on non-constant input, i.e. what the constexpr path would cost at run time.
+        std::array<uint8_t, sizeof(gimp::header_data)> runtimePixels{};
+        std::copy(logo.pixels.begin(), logo.pixels.end(), runtimePixels.begin());
+        record("compressBinaryArray (runtime)", measure(runtimePixels.size(), [&] {
+            sinkValue = kmk::compressBinaryArray(runtimePixels)[sinkValue % 8];
+        }));
+        std::cout << "  constexpr results cost nothing at run time (" << rlePacked.size() << " bytes of RLE in flash)\n";
+    }
+
+    for (const auto& [w, h] : std::vector<std::pair<std::size_t, std::size_t>>{{128, 64}, {256, 128}, {512, 512}, {1024, 1024}, {2048, 2048}}) {
+        const std::string size = std::to_string(w) + "x" + std::to_string(h);
+        std::cout << size << "\n";
+
+        const generator::Image image = syntheticImage(w, h);
+        const std::size_t pixelBytes = image.pixels.size();
+
+        std::vector<uint8_t> row(kmk::rowMajorSize(w, h));
+        std::vector<uint8_t> page(kmk::pageMajorSize(w, h));
+        kmk::packRowMajor(image.pixels.data(), w, h, row.data());
+        kmk::packPageMajor(image.pixels.data(), w, h, page.data());
+        verify(row == reference::rowMajor(image), size + " packRowMajor == reference");
+        verify(page == reference::pageMajor(image), size + " packPageMajor == reference");
+
+        std::vector<uint8_t> encoded;
+        kmk::rle::encode(page.data(), page.size(), [&](uint8_t byte) { encoded.push_back(byte); });
+        verify(reference::rleDecode(encoded) == page, size + " rle::encode round trip (reference decoder)");
+
+        std::vector<uint8_t> framebuffer(page.size());
+        kmk::rle::decode(encoded.data(), encoded.size(), kmk::ssd1306::PageMajorSink{framebuffer.data(), w, w});
+        verify(framebuffer == page, size + " rle::decode into PageMajorSink");
+
+        record(size + " packRowMajor", measure(pixelBytes, [&] {
+            std::fill(row.begin(), row.end(), 0);
+            kmk::packRowMajor(image.pixels.data(), w, h, row.data());
+            sinkValue = row[0];
+        }));
+        record(size + " packPageMajor", measure(pixelBytes, [&] {
+            std::fill(page.begin(), page.end(), 0);
+            kmk::packPageMajor(image.pixels.data(), w, h, page.data());
+            sinkValue = page[0];
+        }));
+        record(size + " rle::encode", measure(page.size(), [&] {
+            std::size_t count = 0;
+            kmk::rle::encode(page.data(), page.size(), [&](uint8_t byte) { count += byte; });
+            sinkValue = count;
+        }));
+        record(size + " rle::decode (framebuffer)", measure(page.size(), [&] {
+            kmk::rle::decode(encoded.data(), encoded.size(), kmk::ssd1306::PageMajorSink{framebuffer.data(), w, w});
+            sinkValue = framebuffer[0];
+        }));
+
+        const generator::GreyImage grey = gradientImage(w, h);
+        record(size + " dither ordered", measure(grey.grey.size(), [&] {
+            sinkValue = generator::dither(grey, generator::Dither::Ordered).pixels[0];
+        }));
+        record(size + " dither floyd", measure(grey.grey.size(), [&] {
+            sinkValue = generator::dither(grey, generator::Dither::FloydSteinberg).pixels[0];
+        }));
+    }
+
+    if (!saveBaseline.empty()) {
+        std::ofstream out(saveBaseline);
+        for (const auto& result : results) {
+            out << result.megabytesPerSecond << " " << result.name << "\n";
+        }
+        std::cout << "Saved baseline to " << saveBaseline << "\n";
+    }
+
+    if (!checkBaseline.empty()) {
+        std::ifstream in(checkBaseline);
+        std::map<std::string, double> baseline;
+        double mbps;
+        std::string name;
+        while (in >> mbps && std::getline(in >> std::ws, name)) {
+            baseline[name] = mbps;
+        }
+        for (const auto& result : results) {
+            const auto it = baseline.find(result.name);
+            if (it != baseline.end() && result.megabytesPerSecond < it->second * (1.0 - tolerance)) {
+                std::cerr << "REGRESSION: " << result.name << " " << result.megabytesPerSecond << " MB/s, baseline "
+                          << it->second << " MB/s\n";
+                ++failures;
+            }
+        }
+    }
+
+    std::cout << (failures == 0 ? "All checks passed." : "Some checks FAILED.") << std::endl;
+    return failures == 0 ? 0 : 1;
+}
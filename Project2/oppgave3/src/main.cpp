@@ -5,7 +5,25 @@
 #include <SPI.h>
 #include <Wire.h>
 #include <string.h>
-#include "mas245_logo_bitmap.h"
+#include <kmk/can.h>
+#include <kmk/can_schema.h>
+#include <kmk/can_stats.h>
+#include <kmk/can_tx.h>
+#include <kmk/compositor.h>
+#include <kmk/log.h>
+#include <kmk/packet.h>
+#include <kmk/profile.h>
+#include <kmk/spsc_ring.h>
+#include <kmk/ssd1306_flush.h>
+#include <kmk/ssd1306_spi.h>
+#ifdef STREAM_FRAMES
+#include <kmk/stream.h>
+#endif
+#include "can_messages.h"
+#include "log_messages.h"
+#include "pumpkin_bitmap.h"
+#include "screens.h"
+#include "sprites_sheet.h"
 
 // Namespace declarations remain unchanged
 namespace carrier {
@@ -19,6 +37,8 @@ namespace carrier {
     constexpr uint8_t oledDcPower{6};
     constexpr uint8_t oledCs{10};
     constexpr uint8_t oledReset{5};
+    // Second OLED (-D SECOND_OLED): same SPI pins, D/C and reset as the first, its own chip select.
+    constexpr uint8_t secondOledCs{9};
   }
 
   namespace oled {
@@ -27,37 +47,12 @@ namespace carrier {
   }
 }
 
-namespace images {
-  namespace pumpkin {
-    constexpr uint8_t width{16};
-    constexpr uint8_t height{18};
-
-    constexpr static uint8_t PROGMEM bitmap[] = {
-      0b00000000, 0b00100000,
-      0b00000000, 0b11100000,
-      0b00000001, 0b10000000,
-      0b00000001, 0b10000000,
-      0b00000001, 0b10000000,
-      0b00000011, 0b11100000,
-      0b00001111, 0b11111000,
-      0b00111111, 0b11111000,
-      0b01111111, 0b11111110,
-      0b01111111, 0b11111110,
-      0b11111111, 0b11111111,
-      0b11111111, 0b11111111,
-      0b11111111, 0b11111111,
-      0b01111111, 0b11111110,
-      0b01111111, 0b11111110,
-      0b00011111, 0b11111000,
-      0b00011111, 0b11110000,
-      0b00000111, 0b11100000,
-    };
-  };
-}
-
 namespace {
-  CAN_message_t msg;
+  constexpr uint32_t canBitrate = 250000;
   FlexCAN_T4<CAN0, RX_SIZE_256, TX_SIZE_16> can0;
+  // Filled by the receive interrupt (canReceived()), emptied by every loop() pass. 256 frames is about
+  // 60 ms of a full 250 kbit/s bus, far longer than a pass takes.
+  kmk::SpscRing<kmk::can::Frame, 256> canRx;
 
   Adafruit_SSD1306 display(carrier::oled::screenWidth,
                            carrier::oled::screenHeight,
@@ -65,8 +60,112 @@ namespace {
                            carrier::pin::oledDcPower,
                            carrier::pin::oledReset,
                            carrier::pin::oledCs);
-  uint32_t receivedMessageCount = 0;
+  // Frames are sent through the diff flusher instead of display.display(), only changed columns go over SPI.
+  kmk::ssd1306::SpiLink oledLink(SPI, carrier::pin::oledDcPower, carrier::pin::oledCs);
+  using Flusher = kmk::ssd1306::DiffFlusher<kmk::ssd1306::SpiLink>;
+  Flusher flusher(oledLink);
+  // Binary packets to the USB serial port, written from loop() as the port has room; src/frame_viewer.cpp
+  // shows them on the PC. Log records instead of Serial.print(): a few bytes copied, the text is made there.
+  kmk::packet::Channel<decltype(Serial)> serialOut(Serial);
+  kmk::log::Logger<decltype(serialOut)> logger(serialOut);
+  // 'p' or 's' waiting for the packets queued before it, so the text does not land in the middle of one.
+  char pendingReport = 0;
+  // Serial bytes written per loop() pass while a report waits.
+  constexpr std::size_t reportFlushBytes = 512;
+#ifdef STREAM_FRAMES
+  // Every frame also goes out, between the log records.
+  kmk::stream::FrameStreamer<decltype(serialOut)> streamer(serialOut);
+#endif
+  // Title, arc and labels are drawn once into the background, each frame only restores what moved.
+  using Compositor = kmk::ssd1306::Compositor<carrier::oled::screenWidth, carrier::oled::screenHeight>;
+  Compositor compositor;
+#ifdef SECOND_OLED
+  // The CAN statistics get the second panel and the first shows only the animation. No reset pin here,
+  // the shared reset line is pulsed by display.begin() and would blank the first panel again.
+  Adafruit_SSD1306 statsDisplay(carrier::oled::screenWidth,
+                                carrier::oled::screenHeight,
+                                &SPI,
+                                carrier::pin::oledDcPower,
+                                -1,
+                                carrier::pin::secondOledCs);
+  kmk::ssd1306::SpiLink statsLink(SPI, carrier::pin::oledDcPower, carrier::pin::secondOledCs);
+  Flusher statsFlusher(statsLink);
+  Compositor statsCompositor;
+  // Each panel keeps its own shadow; the scheduler takes turns between them, one chunk per loop() pass.
+  kmk::ssd1306::FlushScheduler<Flusher, 2> panels(flusher, statsFlusher);
+  constexpr std::size_t busiestRows = 3;
+#else
+  // One panel shows it all.
+  Adafruit_SSD1306& statsDisplay = display;
+  Compositor& statsCompositor = compositor;
+  kmk::ssd1306::FlushScheduler<Flusher, 1> panels(flusher);
+  constexpr std::size_t busiestRows = 1;
+#endif
+  screens::CanStatsPage<busiestRows> canStatsPage;
+  // Statistics per CAN ID; 64 slots hold 48 IDs. 's' over serial prints all of it.
+  kmk::can::Statistics<64> canStats(canBitrate);
   uint32_t lastReceivedMessageID = 0;
+
+  // The circle moves one step every stepMillis; loop() keeps servicing CAN and the display in between.
+  constexpr uint32_t stepMillis = 100;
+  // Framebuffer bytes sent per loop() pass, ~40 us at 8 MHz SPI between CAN polls.
+  constexpr std::size_t flushChunkBytes = 32;
+  uint32_t lastStepMillis = 0;
+  std::size_t animationFrame = 0;
+
+  // Sending goes through a scheduler instead of straight to can0.write(): the newest coordinates replace
+  // ones still waiting for a mailbox, and coordinates a step old are dropped. 'p' prints its counters.
+  namespace tx {
+    enum : uint8_t { Coordinates, Count };
+  }
+  constexpr std::array<kmk::can::TxClass, tx::Count> txClasses{{
+    {0, 0, stepMillis * 1000},
+  }};
+  kmk::can::TxScheduler<tx::Count> canTx(txClasses);
+  kmk::can::DriverBus<CAN_message_t, decltype(can0)> canBus(can0);
+
+  // Logs the coordinates as they are handed to a mailbox.
+  struct LoggedBus {
+    bool write(const kmk::can::Frame& frame) {
+      if (!canBus.write(frame)) {
+        return false;
+      }
+      messages::Coordinates coordinates;
+      if (frame.id == messages::Coordinates::id && kmk::can::decode(frame.data, frame.length, coordinates)) {
+        logger.write(logs::CanSent, micros(), coordinates.x, coordinates.y);
+      }
+      return true;
+    }
+  } loggedBus;
+
+  // Splash and blinking, stepped from loop() while CAN is already being read.
+  kmk::Sequence<startup::Step> startupSequence(startup::steps);
+
+  // The cycle counter (DWT) counts CPU cycles, 180 per microsecond; Scope's subtraction survives its wrap-around.
+  struct CycleCounter {
+    static void enable() {
+      ARM_DEMCR |= ARM_DEMCR_TRCENA;
+      ARM_DWT_CTRL |= ARM_DWT_CTRL_CYCCNTENA;
+    }
+    static uint32_t now() { return ARM_DWT_CYCCNT; }
+  };
+  constexpr uint32_t cyclesPerMicro = F_CPU / 1000000;
+  using Timed = kmk::profile::Scope<CycleCounter>;
+
+  // Time spent per drawing and sending stage. Over serial: 'p' prints the histograms, 'r' resets them,
+  // 'o' shows the frame time on the OLED.
+  namespace stage {
+    enum : uint8_t { Frame, Compose, Stats, Circle, Spinner, Submit, Pump, Background, Count };
+  }
+  kmk::profile::Stage stages[stage::Count]{
+    {"frame"}, {"compose"}, {"stats"}, {"circle"}, {"spinner"}, {"submit"}, {"pump"}, {"background"},
+  };
+  bool showTimings = false;
+
+  // Spinner in the top right corner, shows that the loop is alive.
+  kmk::AnimationPlayer spinner(images::sprites::data,
+                               images::sprites::sprites[images::sprites::spinner],
+                               carrier::oled::screenWidth - 8, 0);
 }
 
 struct Message {
@@ -74,157 +173,262 @@ struct Message {
   float temperature;
 };
 
-void drawSplash();
+void submitFrame();
+void startupStep(startup::Step step);
 void demoMessage();
+void canReceived(const CAN_message_t& message);
 void receiveCan();
-void drawFrameWithTitleAndArc();
+void readCommands();
+void printStatus();
+void printCanStats();
+void printCanTx();
 void sendCan(int16_t x, int16_t y);
+void animationStep(const kmk::Point& point);
 
 void setup() {
   Serial.begin(9600);
+  CycleCounter::enable();
   can0.begin();
-  can0.setBaudRate(250000);
+  can0.setBaudRate(canBitrate);
+  // Frames are taken from the FIFO in its interrupt. events() is never called, so FlexCAN_T4 runs
+  // the callback right there instead of queueing the frames for loop().
+  can0.enableFIFO();
+  can0.enableFIFOInterrupt();
+  can0.onReceive(canReceived);
 
   if (!display.begin(SSD1306_SWITCHCAPVCC)) {
     Serial.println(F("ERROR: display.begin(SSD1306_SWITCHCAPVCC) failed."));
     for (;;) { }
   }
+#ifdef SECOND_OLED
+  if (!statsDisplay.begin(SSD1306_SWITCHCAPVCC)) {
+    Serial.println(F("ERROR: statsDisplay.begin(SSD1306_SWITCHCAPVCC) failed."));
+    for (;;) { }
+  }
+#endif
 
-  display.clearDisplay();
-  display.display();
-  delay(2000);
+  logger.write(logs::FloatSize, micros(), static_cast<uint32_t>(sizeof(float)));
+  // The splash and the CAN screen follow from loop(), see startupStep().
+}
 
-  drawSplash();
-  delay(2000);
-  display.invertDisplay(true);
-  delay(500);
-  display.invertDisplay(false);
-  delay(1000);
-  display.invertDisplay(true);
-  delay(100);
-  display.invertDisplay(false);
-  delay(1000);
+void loop() {
+  receiveCan();
+  canTx.pump(micros(), loggedBus);
+  readCommands();
+  if (panels.busy()) {
+    Timed pumpTime(stages[stage::Pump].histogram);
+    panels.pump(flushChunkBytes);
+  }
+  serialOut.pump();
 
-  Serial.print(F("float size in bytes: "));
-  Serial.println(sizeof(float));
+  // The next frame is drawn once the last one is on the panels.
+  if (panels.busy()) {
+    return;
+  }
+  if (!startupSequence.done()) {
+    startupSequence.poll(millis(), startupStep);
+    return;
+  }
+  if (millis() - lastStepMillis < stepMillis) {
+    return;
+  }
+  lastStepMillis = millis();
+
+  // Rundt ellipsen, og så det samme bare andre veien
+  const std::size_t points = animation::ellipse.size();
+  const std::size_t index = animationFrame < points ? animationFrame : 2 * points - 1 - animationFrame;
+  animationStep(animation::ellipse[index]);
+  animationFrame = (animationFrame + 1) % (2 * points);
 }
 
-void loop() {
-  demoMessage(); 
-  // lager størelsen til sirkelen og banen
-  const int16_t centerX = carrier::oled::screenWidth / 2;
-  const int16_t centerY = 60;
-  const int16_t radiusX = 50;
-  const int16_t radiusY = 4;
-  const int16_t circleRadius = 3;
-  int16_t lastX = 0, lastY = 0;
-
-  for (float angle = 0; angle <= 360; angle += 5) {
-    float radians = angle * PI / 180.0;
-    int16_t x = centerX + radiusX * cos(radians);
-    int16_t y = centerY + radiusY * sin(radians);
-    receiveCan();
-        // Fjerner sirkelen
-    display.fillCircle(lastX, lastY, circleRadius, SSD1306_BLACK);
-
-    // Tegner sirkelen
-    display.fillCircle(x, y, circleRadius, SSD1306_WHITE);
-
-    display.display();
-
-    lastX = x;
-    lastY = y;
-    
-    delay(100);
-    
-    sendCan(x, y);
-  }
-  // Dette gjør det samme bare andre veien
-  for (float angle = 360; angle >= 0; angle -= 5) {
-    float radians = angle * PI / 180.0;
-    int16_t x = centerX + radiusX * cos(radians);
-    int16_t y = centerY + radiusY * sin(radians);
-    receiveCan();
-    
-    display.fillCircle(lastX, lastY, circleRadius, SSD1306_BLACK);
-
-   
-    display.fillCircle(x, y, circleRadius, SSD1306_WHITE);
-
-    display.display();
-
-    lastX = x;
-    lastY = y;
-    
-    delay(100);
-   
-    sendCan(x, y);
+void animationStep(const kmk::Point& point) {
+  {
+    Timed frameTime(stages[stage::Frame].histogram);
+    {
+      // Fjerner sirkelen fra forrige bilde
+      Timed t(stages[stage::Compose].histogram);
+      compositor.compose(display.getBuffer());
+    }
+    {
+      // Costs two compares when nothing arrived, a few glyphs when the count ticks.
+      Timed t(stages[stage::Stats].histogram);
+      canStatsPage.update(statsDisplay, statsCompositor, canStats, lastReceivedMessageID, micros());
+    }
+    {
+      Timed t(stages[stage::Circle].histogram);
+      screens::drawCircle(display, compositor, point);
+    }
+    {
+      Timed t(stages[stage::Spinner].histogram);
+      spinner.next(display.getBuffer(), carrier::oled::screenWidth);
+    }
+  }
+  if (showTimings) {
+    screens::drawTimingOverlay(display, compositor, stages[stage::Frame].histogram, cyclesPerMicro);
   }
+
+  // Sent in chunks from loop(), the display buffer can be drawn into again right away.
+  {
+    Timed t(stages[stage::Submit].histogram);
+    submitFrame();
+  }
+
+  sendCan(point.x, point.y);
 }
-// sender kordinatene til PCAN view
+
+// Sends the coordinates to PCAN-View; loop() hands them to a mailbox as soon as one is free.
 void sendCan(int16_t x, int16_t y) {
-  CAN_message_t msg;
-  msg.id = 0x245;
-  msg.len = 4;
-
-  msg.buf[0] = x & 0xFF;
-  msg.buf[1] = (x >> 8) & 0xFF;
-  msg.buf[2] = y & 0xFF;
-  msg.buf[3] = (y >> 8) & 0xFF;
-
-  if (can0.write(msg) < 0) {
-    Serial.println("CAN send failed.");
-  } else {
-    Serial.print("Sent Coordinates - X: ");
-    Serial.print(x);
-    Serial.print(", Y: ");
-    Serial.println(y);
-  }
+  canTx.queue(tx::Coordinates, messages::Coordinates::id, messages::Coordinates{x, y}, micros());
 }
 
+// Runs in the interrupt: only copies the frame, everything else is done by receiveCan() in loop().
+void canReceived(const CAN_message_t& message) {
+  kmk::can::Frame frame{micros(), message.id, message.len, static_cast<bool>(message.flags.extended), {}};
+  memcpy(frame.data, message.buf, sizeof(frame.data));
+  canRx.push(frame);
+}
+
+// Takes every received frame each time, not one per pass.
 void receiveCan() {
-  if (can0.read(msg)) {
-    receivedMessageCount++;
-    lastReceivedMessageID = msg.id;
+  canRx.drain([](const kmk::can::Frame& frame) {
+    canStats.record(frame);
+    lastReceivedMessageID = frame.id;
+  });
+  canStats.update(micros());
+}
+
+void readCommands() {
+  while (Serial.available() > 0) {
+    const int command = Serial.read();
+    switch (command) {
+      // The reports are text; what is queued goes first, over as many passes as that takes.
+      case 'p':
+      case 's':
+        pendingReport = static_cast<char>(command);
+        break;
+      case 'r':
+        for (kmk::profile::Stage& s : stages) {
+          s.histogram.reset();
+        }
+        break;
+      case 'o':
+        showTimings = !showTimings;
+        break;
+    }
+  }
+  if (pendingReport != 0 && serialOut.flush(reportFlushBytes)) {
+    if (pendingReport == 'p') {
+      printStatus();
+    } else {
+      printCanStats();
+    }
+    pendingReport = 0;
   }
 }
 
-void demoMessage() {
-  drawFrameWithTitleAndArc();
-  // Setter opp Displayet
-  display.setTextSize(1);
-  display.setTextColor(SSD1306_WHITE);
-  display.setCursor(0, 16);
-  display.println(F("CAN-statistikk"));
-  display.println(F("-------------------"));
-  display.print(F("Antall mottatt: "));
-  display.println(receivedMessageCount);
-  display.print(F("Mottok sist ID: 0x"));
-  display.println(lastReceivedMessageID, HEX);
-  display.println(F("-------------------"));
-
-  display.display();
+void printStatus() {
+  kmk::profile::report(Serial, stages, stage::Count, cyclesPerMicro);
+  Serial.print("CAN receive overflows: ");
+  Serial.println(canRx.overflows());
+  Serial.print("Log records dropped: ");
+  Serial.println(logger.dropped());
+  printCanTx();
+}
+
+// One line per CAN ID: count, length and last data, min/avg/max time between frames and the rate.
+void printCanStats() {
+  const uint32_t now = micros();
+  Serial.println("id n len data gap min/avg/max [us] rate [1/s]");
+  canStats.forEach([now](const kmk::can::IdStats& id) {
+    Serial.print("0x");
+    Serial.print(id.id, HEX);
+    Serial.print(' ');
+    Serial.print(id.count);
+    Serial.print(' ');
+    Serial.print(id.length);
+    for (uint8_t i = 0; i < id.length && i < sizeof(id.data); ++i) {
+      Serial.print(i == 0 ? ' ' : ':');
+      Serial.print(id.data[i], HEX);
+    }
+    Serial.print(' ');
+    Serial.print(id.count > 1 ? id.minGap : 0);
+    Serial.print('/');
+    Serial.print(id.meanGap());
+    Serial.print('/');
+    Serial.print(id.maxGap);
+    Serial.print(' ');
+    Serial.println(id.rateAt(now), 1);
+  });
+  Serial.print("frames ");
+  Serial.print(canStats.total());
+  Serial.print(", untracked ");
+  Serial.print(canStats.untracked());
+  Serial.print(", bus load ");
+  Serial.print(canStats.busLoad() * 100.0f, 1);
+  Serial.println("%");
 }
 
-void drawSplash() {
-  namespace splash = images::mas245splash;
-  display.clearDisplay();
-  display.drawBitmap(0, 0, splash::bitmap, splash::width, splash::height, 1);
-  display.display();
+void printCanTx() {
+  const kmk::can::TxCounters& counters = canTx.counters(tx::Coordinates);
+  Serial.print("CAN TX sent ");
+  Serial.print(counters.sent);
+  Serial.print(", coalesced ");
+  Serial.print(counters.coalesced);
+  Serial.print(", dropped ");
+  Serial.print(counters.dropped);
+  Serial.print(", late ");
+  Serial.print(counters.late);
+  Serial.print(", max delay ");
+  Serial.print(counters.maxDelay);
+  Serial.println(" us");
 }
 
-void drawFrameWithTitleAndArc() {
-  display.clearDisplay();
-  // lager overskriften
-  display.setTextSize(1);
-  display.setTextColor(SSD1306_WHITE);
-  display.setCursor(15, 2);
-  display.println(F("MAS245 - Gruppe 3"));
-  // lager linjen under overskriften
-  for (int16_t x = 0; x < carrier::oled::screenWidth; x++) {
-    int16_t y = 15 - (int16_t)(0.1 * (x - 64) * (x - 64) / 64);
-    display.drawPixel(x, y, SSD1306_WHITE);
+void startupStep(startup::Step step) {
+  switch (step) {
+    case startup::Step::Clear:
+      display.clearDisplay();
+      submitFrame();
+      break;
+    case startup::Step::Splash:
+      screens::drawSplash(display);
+      submitFrame();
+      break;
+    // The flushers are idle here, so the invert command does not land in the middle of a frame.
+    case startup::Step::Invert:
+      display.invertDisplay(true);
+      break;
+    case startup::Step::Normal:
+      display.invertDisplay(false);
+      break;
+    case startup::Step::Operational:
+      demoMessage();
+      break;
   }
+}
+
+void demoMessage() {
+  Timed t(stages[stage::Background].histogram);
+  // The static parts become the compositor's background, drawn once instead of every lap.
+  screens::drawFrameWithTitleAndArc(display);
+#ifdef SECOND_OLED
+  compositor.captureBackground(display.getBuffer());
+  screens::drawFrameWithTitleAndArc(statsDisplay);
+#endif
+  canStatsPage.drawLabels(statsDisplay);
+  statsCompositor.captureBackground(statsDisplay.getBuffer());
+
+  canStatsPage.update(statsDisplay, statsCompositor, canStats, lastReceivedMessageID, micros());
+  spinner.reset(display.getBuffer(), carrier::oled::screenWidth);
+  submitFrame();
+}
 
-  display.display();
+// Only called while the flushers are idle; the frames go out in chunks from loop().
+void submitFrame() {
+  flusher.submit(display.getBuffer());
+#ifdef SECOND_OLED
+  statsFlusher.submit(statsDisplay.getBuffer());
+#endif
+#ifdef STREAM_FRAMES
+  streamer.submit(display.getBuffer());
+#endif
 }
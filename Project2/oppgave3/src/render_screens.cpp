@@ -0,0 +1,618 @@
+// Renders the firmware screens and the Pong frames into the SSD1306 emulator (lib/kmk/src/kmk/emulator.h).
+// Writes what the panel shows as PBM files, compares them with the golden images in test/golden and reports what
+// each frame costs. Fails if a pixel differs or a golden image is missing.
+// Build and run with: pio run -e render_screens && .pio/build/render_screens/program [--out screens] [--golden <dir>]
+// After an intended change of a screen: .pio/build/render_screens/program --out test/golden
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <exception>
+#include <filesystem>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <kmk/can_stats.h>
+#include <kmk/compositor.h>
+#include <kmk/emulator.h>
+#include <kmk/pong.h>
+#include <kmk/profile.h>
+#include <kmk/sequence.h>
+#include <kmk/sprite.h>
+#include <kmk/ssd1306_flush.h>
+
+#include "generator/asset.h"
+#include "screens.h"
+#include "sprites_sheet.h"
+
+namespace
+{
+    using Flusher = kmk::ssd1306::DiffFlusher<kmk::emulator::Panel>;
+
+    // Framebuffer bytes the diff flusher may send per pump() call, as main.cpp does between CAN polls.
+    constexpr std::size_t pumpBytes = 32;
+
+    /**
+     * What a scene cost, averaged over its frames. fullBytes/fullNanos is what display() sends and how long
+     * it blocks, diffBytes what the DiffFlusher sends for the same frames, and pumpNanos the longest a
+     * single pump() call kept the (simulated, 8 MHz) SPI bus busy.
+    */
+    struct Cost {
+        std::string name;
+        std::size_t frames{0};
+        std::size_t pixels{0};
+        std::size_t fullBytes{0};
+        uint64_t fullNanos{0};
+        std::size_t diffBytes{0};
+        uint64_t pumpNanos{0};
+    };
+
+    /**
+     * One emulated display with both ways of sending frames: display() into its own panel, and the
+     * diff flusher, submitted and pumped in chunks, into a second panel. Both panels must end up
+     * showing the same image.
+    */
+    struct Bench {
+        kmk::emulator::Display display;
+        kmk::emulator::Panel diffPanel;
+        Flusher flusher{diffPanel};
+        Cost cost;
+        // Simulated SPI time of every pump() call that sent something.
+        kmk::profile::Histogram pumps;
+
+        explicit Bench(const std::string& name) {
+            display.begin(SSD1306_SWITCHCAPVCC);
+            cost.name = name;
+        }
+
+        void frame() {
+            display.display();
+            flusher.submit(display.getBuffer());
+            while (flusher.busy()) {
+                const uint64_t before = diffPanel.transferNanos();
+                flusher.pump(pumpBytes);
+                pumps.add(static_cast<uint32_t>(diffPanel.transferNanos() - before));
+            }
+            ++cost.frames;
+        }
+
+        void invertDisplay(bool invert) {
+            display.invertDisplay(invert);
+            const uint8_t command = invert ? 0xA7 : 0xA6;
+            diffPanel.command(&command, 1);
+        }
+
+        Cost finish() {
+            cost.pixels = display.pixelsTouched();
+            cost.fullBytes = display.panel().dataBytes();
+            cost.fullNanos = display.panel().transferNanos();
+            cost.diffBytes = diffPanel.dataBytes();
+            cost.pumpNanos = pumps.max();
+            return cost;
+        }
+    };
+
+    using CanStats = kmk::can::Statistics<64>;
+
+    /**
+     * Made-up CAN traffic at fixed times, so the CAN screens come out the same on every run: 0x245 (4 bytes)
+     * at 100 frames/s, 0x100 at 50 and 0x7DF at 10. Covers millis from start (in us); returns the time after.
+    */
+    uint32_t sampleTraffic(CanStats& stats, uint32_t start, uint32_t millis) {
+        for (uint32_t ms = 0; ms < millis; ++ms) {
+            const uint32_t now = start + ms * 1000;
+            const uint32_t tick = now / 1000;
+            if (tick % 10 == 0) {
+                stats.record({now, 0x245, 4, false, {0x72, 0x00, 0x3C, 0x00}});
+            }
+            if (tick % 20 == 5) {
+                stats.record({now, 0x100, 8, false, {1, 2, 3, 4, 5, 6, 7, 8}});
+            }
+            if (tick % 100 == 7) {
+                stats.record({now, 0x7DF, 2, false, {0x01, 0x0D}});
+            }
+        }
+        const uint32_t end = start + millis * 1000;
+        stats.update(end);
+        return end;
+    }
+
+    // Host time in nanoseconds for kmk::profile::Scope, where the firmware counts CPU cycles.
+    struct HostClock {
+        static uint32_t now() {
+            const auto since = std::chrono::steady_clock::now().time_since_epoch();
+            return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(since).count());
+        }
+    };
+
+    // Serial's print() on stdout, for kmk::profile::report().
+    struct StdoutPrint {
+        void print(const char* text) { std::fputs(text, stdout); }
+        void print(unsigned long value) { std::printf("%lu", value); }
+    };
+
+    /**
+     * CAN traffic as seen by FlexCAN_T4: a frame arrives every period and waits in a receive queue of
+     * capacity frames (RX_SIZE_256 in main.cpp) until receiveCan() reads it, one per call. Times in ns.
+    */
+    struct CanBus {
+        static constexpr uint64_t never = ~uint64_t{0};
+
+        uint64_t period;
+        std::size_t capacity;
+        uint64_t nextArrival{0};
+        std::size_t queued{0};
+        std::size_t lost{0};
+        uint64_t firstProcessed{never};
+
+        void advance(uint64_t now) {
+            for (; nextArrival <= now; nextArrival += period) {
+                if (queued < capacity) {
+                    ++queued;
+                } else {
+                    ++lost;
+                }
+            }
+        }
+
+        void receive(uint64_t now) {
+            advance(now);
+            if (queued > 0) {
+                --queued;
+                if (firstProcessed == never) {
+                    firstProcessed = now;
+                }
+            }
+        }
+    };
+
+    /**
+     * main.cpp from the end of display.begin() until the CAN screen is on the panel, on a simulated clock.
+     * SPI transfers take the emulated panel's transfer time, a loop() pass without SPI loopPassNanos, and
+     * delay() just moves the clock on.
+    */
+    struct Boot {
+        // receiveCan() and the checks in loop(), a generous guess for a 180 MHz Teensy 3.6.
+        static constexpr uint64_t loopPassNanos = 2000;
+
+        kmk::emulator::Display display;
+        kmk::emulator::Panel panel;
+        Flusher flusher{panel};
+        kmk::ssd1306::Compositor<128, 64> compositor;
+        screens::CanStatsPage<1> page;
+        CanStats stats{250000};
+        CanBus can;
+        uint64_t now{0};
+        uint64_t operational{0};
+
+        explicit Boot(const CanBus& bus) : can(bus) { display.begin(SSD1306_SWITCHCAPVCC); }
+
+        uint32_t millis() const { return static_cast<uint32_t>(now / 1000000); }
+
+        template<typename Transfer>
+        void spi(Transfer&& transfer) {
+            const uint64_t before = panel.transferNanos();
+            transfer();
+            now += panel.transferNanos() - before;
+        }
+
+        // Draws what step shows into the framebuffer, or sends its command; true if a frame has to be sent.
+        bool draw(startup::Step step) {
+            switch (step) {
+                case startup::Step::Clear:
+                    display.clearDisplay();
+                    return true;
+                case startup::Step::Splash:
+                    screens::drawSplash(display);
+                    return true;
+                case startup::Step::Invert:
+                case startup::Step::Normal: {
+                    const uint8_t command = step == startup::Step::Invert ? 0xA7 : 0xA6;
+                    spi([&] { panel.command(&command, 1); });
+                    return false;
+                }
+                case startup::Step::Operational:
+                    screens::drawFrameWithTitleAndArc(display);
+                    page.drawLabels(display);
+                    compositor.captureBackground(display.getBuffer());
+                    page.update(display, compositor, stats, 0, 0);
+                    operational = now;
+                    return true;
+            }
+            return false;
+        }
+
+        // setup() as it was: every step flushed at once, then delay() for its hold, CAN only read from loop().
+        void blockingSetup() {
+            for (const auto& step : startup::steps) {
+                if (draw(step.action)) {
+                    spi([&] { flusher.flush(display.getBuffer()); });
+                }
+                now += static_cast<uint64_t>(step.holdMillis) * 1000000;
+                can.advance(now);
+            }
+            runLoop([] { return true; });
+        }
+
+        // loop() as it is: CAN read and a chunk of the frame sent on every pass, the sequence stepped in between.
+        void sequencedStartup() {
+            kmk::Sequence<startup::Step> sequence(startup::steps);
+            runLoop([&] {
+                if (!flusher.busy() && !sequence.done()) {
+                    sequence.poll(millis(), [&](startup::Step step) {
+                        if (draw(step)) {
+                            flusher.submit(display.getBuffer());
+                        }
+                    });
+                }
+                return sequence.done() && !flusher.busy();
+            });
+        }
+
+        template<typename Pass>
+        void runLoop(Pass&& pass) {
+            for (bool finished = false; !finished || can.firstProcessed == CanBus::never;) {
+                can.receive(now);
+                spi([&] { flusher.pump(pumpBytes); });
+                finished = pass();
+                now += loopPassNanos;
+            }
+        }
+    };
+
+    /**
+     * The -D SECOND_OLED firmware on two emulated panels sharing one bus: the animation on the main panel, the
+     * CAN statistics on the second, each with its own flusher and one FlushScheduler pumping both.
+    */
+    struct TwoPanels {
+        kmk::emulator::Display main;
+        kmk::emulator::Display stats;
+        kmk::emulator::Panel mainPanel;
+        kmk::emulator::Panel statsPanel;
+        Flusher mainFlusher{mainPanel};
+        Flusher statsFlusher{statsPanel};
+        kmk::ssd1306::FlushScheduler<Flusher, 2> panels{mainFlusher, statsFlusher};
+        std::size_t frames{0};
+        std::size_t pumps{0};
+        std::size_t turnsSkipped{0};  // Pumps that served the same panel again while the other one waited.
+        uint64_t pumpNanos{0};
+
+        TwoPanels() {
+            main.begin(SSD1306_SWITCHCAPVCC);
+            stats.begin(SSD1306_SWITCHCAPVCC);
+        }
+
+        void frame() {
+            mainFlusher.submit(main.getBuffer());
+            statsFlusher.submit(stats.getBuffer());
+            int last = -1;
+            while (panels.busy()) {
+                const bool bothBusy = mainFlusher.busy() && statsFlusher.busy();
+                const std::size_t mainBefore = mainPanel.dataBytes();
+                const uint64_t before = mainPanel.transferNanos() + statsPanel.transferNanos();
+                panels.pump(pumpBytes);
+                pumpNanos = std::max(pumpNanos, mainPanel.transferNanos() + statsPanel.transferNanos() - before);
+                const int served = mainPanel.dataBytes() != mainBefore ? 0 : 1;
+                turnsSkipped += bothBusy && served == last;
+                last = served;
+                ++pumps;
+            }
+            ++frames;
+        }
+
+        // Both panels must show exactly their framebuffer, whatever order the chunks went out in.
+        bool matches() {
+            return std::equal(main.getBuffer(), main.getBuffer() + 1024, mainPanel.ram())
+                   && std::equal(stats.getBuffer(), stats.getBuffer() + 1024, statsPanel.ram());
+        }
+    };
+
+    /**
+     * Adafruit's classic font (5 columns per glyph) cut out of the 6x8 grid in res/font5x7.pbm.
+    */
+    std::vector<uint8_t> classicFont(const std::filesystem::path& path) {
+        const generator::Image grid = generator::parsePbm(generator::readFile(path), path.string());
+        const std::size_t cellsPerRow = grid.width / 6;
+        std::vector<uint8_t> columns;
+        for (std::size_t c = 0; c < cellsPerRow * (grid.height / 8); ++c) {
+            for (std::size_t i = 0; i < 5; ++i) {
+                uint8_t column = 0;
+                for (std::size_t bit = 0; bit < 8; ++bit) {
+                    const std::size_t x = (c % cellsPerRow) * 6 + i;
+                    const std::size_t y = (c / cellsPerRow) * 8 + bit;
+                    column = static_cast<uint8_t>(column | (grid.pixels[y * grid.width + x] ? 1 << bit : 0));
+                }
+                columns.push_back(column);
+            }
+        }
+        return columns;
+    }
+
+    /**
+     * Number of pixels that differ between the panel and a golden PBM, or -1 if the golden image is missing.
+    */
+    long compareWithGolden(const kmk::emulator::Panel& panel, const std::filesystem::path& path) {
+        if (!std::filesystem::exists(path)) {
+            return -1;
+        }
+        const generator::Image golden = generator::parsePbm(generator::readFile(path), path.string());
+        if (golden.width != kmk::emulator::Panel::width || golden.height != kmk::emulator::Panel::height) {
+            return static_cast<long>(golden.width * golden.height);
+        }
+        long differences = 0;
+        for (int16_t y = 0; y < panel.height; ++y) {
+            for (int16_t x = 0; x < panel.width; ++x) {
+                differences += panel.pixel(x, y) != (golden.pixels[y * golden.width + x] != 0);
+            }
+        }
+        return differences;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    std::filesystem::path outDir{"screens"};
+    std::filesystem::path goldenDir{"test/golden"};
+    std::filesystem::path fontPath{"res/font5x7.pbm"};
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg(argv[i]);
+        if (arg == "--out" && i + 1 < argc) {
+            outDir = argv[++i];
+        } else if (arg == "--golden" && i + 1 < argc) {
+            goldenDir = argv[++i];
+        } else if (arg == "--font" && i + 1 < argc) {
+            fontPath = argv[++i];
+        } else {
+            std::cerr << "Usage: " << argv[0] << " [--out <dir>] [--golden <dir>] [--font res/font5x7.pbm]\n";
+            return 1;
+        }
+    }
+
+    try {
+        const std::vector<uint8_t> font = classicFont(fontPath);
+        std::vector<std::unique_ptr<Bench>> benches;
+        auto bench = [&](const std::string& name) -> Bench& {
+            benches.push_back(std::make_unique<Bench>(name));
+            return *benches.back();
+        };
+
+        {
+            Bench& b = bench("splash");
+            screens::drawSplash(b.display);
+            b.frame();
+        }
+        {
+            // invertDisplay() is a command, the RAM is not sent again.
+            Bench& b = bench("splash_inverted");
+            screens::drawSplash(b.display);
+            b.frame();
+            b.invertDisplay(true);
+        }
+        {
+            Bench& b = bench("title_arc");
+            screens::drawFrameWithTitleAndArc(b.display);
+            b.frame();
+        }
+        {
+            Bench& b = bench("can_stats");
+            kmk::ssd1306::Compositor<128, 64> compositor;
+            screens::CanStatsPage<1> page;
+            CanStats stats(250000);
+            const uint32_t now = sampleTraffic(stats, 0, 1000);
+            screens::drawFrameWithTitleAndArc(b.display);
+            page.drawLabels(b.display);
+            compositor.captureBackground(b.display.getBuffer());
+            page.update(b.display, compositor, stats, 0x245, now);
+            b.frame();
+        }
+        {
+            // The CAN screen as it was drawn before the font atlas, with print() and one drawPixel per lit pixel.
+            Bench& b = bench("can_stats_print");
+            b.display.setClassicFont(font.data(), ' ', static_cast<uint16_t>(font.size() / 5));
+            screens::drawFrameWithTitleAndArc(b.display);
+            b.display.setTextColor(SSD1306_WHITE);
+            b.display.setCursor(0, 16);
+            b.display.println("CAN-statistikk");
+            b.display.println("-------------------");
+            b.display.print("Antall mottatt: ");
+            b.display.println(1234);
+            b.display.print("Mottok sist ID: 0x");
+            b.display.println(0x245, 16);
+            b.display.println("-------------------");
+            b.frame();
+        }
+        // Same stages as main.cpp times with the cycle counter; here host nanoseconds, the pump on the simulated bus.
+        enum : uint8_t { stageFrame, stageCompose, stageStats, stageCircle, stageSpinner, stagePump, stageCount };
+        kmk::profile::Stage stages[stageCount]{
+            {"frame"}, {"compose"}, {"stats"}, {"circle"}, {"spinner"}, {"pump (SPI)"},
+        };
+        using Timed = kmk::profile::Scope<HostClock>;
+        {
+            // One lap of the circle with the spinner on top of the CAN screen, composed like main.cpp does it.
+            Bench& b = bench("animation");
+            kmk::ssd1306::Compositor<128, 64> compositor;
+            screens::CanStatsPage<1> page;
+            CanStats stats(250000);
+            uint32_t now = sampleTraffic(stats, 0, 1000);
+            screens::drawFrameWithTitleAndArc(b.display);
+            page.drawLabels(b.display);
+            compositor.captureBackground(b.display.getBuffer());
+            page.update(b.display, compositor, stats, 0x245, now);
+            b.frame();
+            b.display.resetCounters();
+            b.diffPanel.resetCounters();
+            b.cost = Cost{b.cost.name};
+
+            kmk::AnimationPlayer spinner(images::sprites::data, images::sprites::sprites[images::sprites::spinner],
+                                         b.display.width() - 8, 0);
+            spinner.reset(b.display.getBuffer(), b.display.width());
+            for (const kmk::Point& point : animation::ellipse) {
+                now = sampleTraffic(stats, now, 100);
+                {
+                    Timed frameTime(stages[stageFrame].histogram);
+                    {
+                        Timed t(stages[stageCompose].histogram);
+                        compositor.compose(b.display.getBuffer());
+                    }
+                    {
+                        Timed t(stages[stageStats].histogram);
+                        page.update(b.display, compositor, stats, 0x245, now);
+                    }
+                    {
+                        Timed t(stages[stageCircle].histogram);
+                        screens::drawCircle(b.display, compositor, point);
+                    }
+                    {
+                        Timed t(stages[stageSpinner].histogram);
+                        spinner.next(b.display.getBuffer(), b.display.width());
+                    }
+                }
+                b.frame();
+            }
+            stages[stagePump].histogram = b.pumps;
+        }
+        {
+            // The frame time overlay ('o' over serial), from fixed samples so the image stays the same.
+            Bench& b = bench("timing_overlay");
+            kmk::ssd1306::Compositor<128, 64> compositor;
+            screens::CanStatsPage<1> page;
+            CanStats stats(250000);
+            const uint32_t now = sampleTraffic(stats, 0, 1000);
+            screens::drawFrameWithTitleAndArc(b.display);
+            page.drawLabels(b.display);
+            compositor.captureBackground(b.display.getBuffer());
+            page.update(b.display, compositor, stats, 0x245, now);
+            screens::drawCircle(b.display, compositor, animation::ellipse[0]);
+            kmk::profile::Histogram frames;
+            for (const uint32_t micros : {380u, 395u, 402u, 977u, 412u}) {
+                frames.add(micros);
+            }
+            screens::drawTimingOverlay(b.display, compositor, frames, 1);
+            b.frame();
+        }
+        {
+            // The ball crossing the screen while both paddles move.
+            Bench& b = bench("pong");
+            const kmk::pong::Geometry geometry{2, 15, 4};
+            for (int16_t step = 0; step < 60; ++step) {
+                const kmk::pong::State state{static_cast<int16_t>(20 + step % 10), static_cast<int16_t>(30 - step % 15),
+                                             static_cast<int16_t>(4 + step * 2), static_cast<int16_t>(10 + step / 2)};
+                kmk::pong::draw(b.display, geometry, state);
+                b.frame();
+            }
+        }
+
+        std::filesystem::create_directories(outDir);
+        bool ok = true;
+        std::printf("%-18s %6s %12s %14s %14s %14s %14s %8s\n", "scene", "frames", "pixels/frame", "display() B/f",
+                    "display() us/f", "diff B/frame", "max pump us", "golden");
+        for (const auto& b : benches) {
+            const Cost cost = b->finish();
+            const kmk::emulator::Panel& panel = b->display.panel();
+
+            if (panel.pbm() != b->diffPanel.pbm()) {
+                std::cerr << cost.name << ": the diff flusher left a different image on the panel than display()\n";
+                ok = false;
+            }
+            generator::writeIfChanged(outDir / (cost.name + ".pbm"), panel.pbm());
+
+            const long differences = compareWithGolden(panel, goldenDir / (cost.name + ".pbm"));
+            const std::string golden = differences < 0 ? "missing"
+                                       : differences == 0 ? "ok" : std::to_string(differences) + " px";
+            ok = ok && differences == 0;
+
+            const std::size_t frames = cost.frames > 0 ? cost.frames : 1;
+            std::printf("%-18s %6zu %12zu %14zu %14llu %14zu %14llu %8s\n", cost.name.c_str(), cost.frames,
+                        cost.pixels / frames, cost.fullBytes / frames,
+                        static_cast<unsigned long long>(cost.fullNanos / frames / 1000), cost.diffBytes / frames,
+                        static_cast<unsigned long long>(cost.pumpNanos / 1000), golden.c_str());
+        }
+
+        // A lap of the animation on two panels, drawn like demoMessage() and animationStep() with SECOND_OLED.
+        TwoPanels two;
+        {
+            kmk::ssd1306::Compositor<128, 64> compositor;
+            kmk::ssd1306::Compositor<128, 64> statsCompositor;
+            screens::CanStatsPage<3> page;
+            CanStats stats(250000);
+            uint32_t now = sampleTraffic(stats, 0, 1000);
+            screens::drawFrameWithTitleAndArc(two.main);
+            compositor.captureBackground(two.main.getBuffer());
+            screens::drawFrameWithTitleAndArc(two.stats);
+            page.drawLabels(two.stats);
+            statsCompositor.captureBackground(two.stats.getBuffer());
+            page.update(two.stats, statsCompositor, stats, 0x245, now);
+            two.frame();
+            const std::size_t mainStart = two.mainPanel.dataBytes();
+            const std::size_t statsStart = two.statsPanel.dataBytes();
+            two.frames = 0;
+
+            kmk::AnimationPlayer spinner(images::sprites::data, images::sprites::sprites[images::sprites::spinner],
+                                         two.main.width() - 8, 0);
+            spinner.reset(two.main.getBuffer(), two.main.width());
+            bool matches = true;
+            for (const kmk::Point& point : animation::ellipse) {
+                now = sampleTraffic(stats, now, 100);
+                compositor.compose(two.main.getBuffer());
+                page.update(two.stats, statsCompositor, stats, 0x245, now);
+                screens::drawCircle(two.main, compositor, point);
+                spinner.next(two.main.getBuffer(), two.main.width());
+                two.frame();
+                matches = matches && two.matches();
+            }
+
+            std::printf("\n%-18s %6s %14s %14s %14s %14s %8s\n", "two panels", "frames", "main B/frame", "stats B/frame",
+                        "max pump us", "turns skipped", "golden");
+            long differences = 0;
+            for (const auto& [name, panel] : {std::pair{"two_panels_main", &two.mainPanel},
+                                              std::pair{"two_panels_stats", &two.statsPanel}}) {
+                generator::writeIfChanged(outDir / (std::string(name) + ".pbm"), panel->pbm());
+                const long panelDifferences = compareWithGolden(*panel, goldenDir / (std::string(name) + ".pbm"));
+                differences = differences < 0 || panelDifferences < 0 ? -1 : differences + panelDifferences;
+            }
+            const std::string golden = differences < 0 ? "missing"
+                                       : differences == 0 ? "ok" : std::to_string(differences) + " px";
+            ok = ok && differences == 0;
+            std::printf("%-18s %6zu %14zu %14zu %14llu %14zu %8s\n", "animation", two.frames,
+                        (two.mainPanel.dataBytes() - mainStart) / two.frames,
+                        (two.statsPanel.dataBytes() - statsStart) / two.frames,
+                        static_cast<unsigned long long>(two.pumpNanos / 1000), two.turnsSkipped, golden.c_str());
+            if (!matches || two.turnsSkipped > 0) {
+                std::cerr << "two panels: a panel does not show its framebuffer, or the scheduler did not take turns\n";
+                ok = false;
+            }
+        }
+
+        std::printf("\nanimation stages, host time (pump: simulated SPI time)\n");
+        StdoutPrint out;
+        kmk::profile::report(out, stages, stageCount, 1, "ns");
+
+        // 1000 CAN frames per second, about a quarter of a 250 kbit/s bus, from power on.
+        const CanBus bus{1000000, 256};
+        Boot blocking(bus);
+        blocking.blockingSetup();
+        Boot sequenced(bus);
+        sequenced.sequencedStartup();
+        std::printf("\n%-18s %16s %16s %16s\n", "startup", "first CAN ms", "CAN frames lost", "CAN screen ms");
+        for (const Boot* boot : {&blocking, &sequenced}) {
+            std::printf("%-18s %16.3f %16zu %16.1f\n", boot == &blocking ? "blocking setup()" : "sequencer",
+                        boot->can.firstProcessed / 1e6, boot->can.lost, boot->operational / 1e6);
+        }
+        if (sequenced.panel.pbm() != blocking.panel.pbm()) {
+            std::cerr << "startup: the sequencer left a different image on the panel than setup()\n";
+            ok = false;
+        }
+        if (sequenced.can.lost > 0 || sequenced.can.firstProcessed > 1000000) {
+            std::cerr << "startup: the sequencer does not read CAN from the start\n";
+            ok = false;
+        }
+
+        std::cout << "Frames written to " << outDir.string() << "/\n";
+        return ok ? 0 : 1;
+    } catch (const std::exception& e) {
+        std::cerr << "render_screens: " << e.what() << '\n';
+        return 1;
+    }
+}
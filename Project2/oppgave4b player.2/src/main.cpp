@@ -4,6 +4,12 @@
 #include <FlexCAN_T4.h>
 #include <SPI.h>
 #include <Wire.h>
+#include <kmk/can_schema.h>
+#include <kmk/can_tx.h>
+#include <kmk/pong.h>
+#include <kmk/pong_can.h>
+#include <kmk/ssd1306_flush.h>
+#include <kmk/ssd1306_spi.h>
 
 // Constants for screen and paddle properties
 namespace carrier
@@ -46,6 +52,21 @@ namespace communication
 {
   CAN_message_t msg;
   FlexCAN_T4<CAN0, RX_SIZE_256, TX_SIZE_16> can0;
+
+  // Frames are queued per message class and sent by sendQueuedFrames(), game state first. A newer frame
+  // replaces one still waiting, and game frames not out within 40 ms are dropped: the next loop has newer ones.
+  // The role goes out every 250 ms and at once when it changes.
+  namespace tx
+  {
+    enum : uint8_t { State, Paddle, Role, Count };
+  }
+  constexpr std::array<kmk::can::TxClass, tx::Count> txClasses{{
+    {0, 0, 40000},
+    {1, 0, 40000},
+    {2, 250000, 0},
+  }};
+  kmk::can::TxScheduler<tx::Count> scheduler(txClasses);
+  kmk::can::DriverBus<CAN_message_t, decltype(can0)> bus(can0);
 }
 
 // Display setup
@@ -56,10 +77,14 @@ Adafruit_SSD1306 display(carrier::oled::screenWidth,
                          carrier::pin::oledReset,
                          carrier::pin::oledCs);
 
+// Only the columns that changed since the last frame are sent, see drawPaddlesAndBall()
+kmk::ssd1306::SpiLink oledLink(SPI, carrier::pin::oledDcPower, carrier::pin::oledCs);
+kmk::ssd1306::DiffFlusher<kmk::ssd1306::SpiLink> flusher(oledLink);
+
 bool isMaster = false;
 bool otherIsMaster = false; // Indicates if the other player is master
 constexpr int Gruppenr = 2;           // Set this to Player 2's number
-constexpr int MotstanderGruppenr = 1; // Player 1's number
+constexpr int MotstanderGruppenr = 3; // Player 1's number, must match Gruppenr in player.1
 
 void handleInput();
 void handleCANInput();
@@ -67,6 +92,7 @@ void gameMasterControll();
 void sendGameState();
 void drawPaddlesAndBall();
 void checkIfMaster();
+void sendQueuedFrames();
 
 void setup()
 {
@@ -82,7 +108,7 @@ void setup()
   }
 
   display.clearDisplay();
-  display.display();
+  flusher.flush(display.getBuffer());
   delay(1000);
 
   // Set joystick pins as input
@@ -112,6 +138,7 @@ void loop()
   }
 
   sendGameState(); // Send game state to slve 
+  sendQueuedFrames();
   handleCANInput(); // Receive game state from other player  
   drawPaddlesAndBall();
   delay(50); // Adjust refresh rate as needed
@@ -119,38 +146,10 @@ void loop()
 
 void checkIfMaster()
 {
-  // If this player is the master, announce it over CAN
-  if (isMaster)
-  {
-    communication::msg.id = 100; // ID for master announcement
-    communication::msg.len = 1;
-    communication::msg.buf[0] = 1; // Indicates this player is master
-    communication::can0.write(communication::msg);
-  }
-
-  // If this player is not the master, send a message confirming this
-  if (!isMaster)
-  {
-    communication::msg.id = 101; // ID for slave response
-    communication::msg.len = 1;
-    communication::msg.buf[0] = 0; // Indicates this player is not master
-    communication::can0.write(communication::msg);
-  }
-
-  // Check for messages from the other player
-  if (communication::can0.read(communication::msg))
-  {
-    // Other player announces they are the master
-    if (communication::msg.id == 100 && communication::msg.buf[0] == 1)
-    {
-      otherIsMaster = true;
-    }
-    // Other player confirms they are not master
-    else if (communication::msg.id == 101 && communication::msg.buf[0] == 0)
-    {
-      otherIsMaster = false;
-    }
-  }
+  // Announce this player's role over CAN; the other player's role is read in handleCANInput()
+  communication::scheduler.queue(communication::tx::Role,
+                                 isMaster ? kmk::pong::masterId : kmk::pong::notMasterId,
+                                 kmk::pong::Role{isMaster}, micros());
 }
 
 void handleInput()
@@ -173,24 +172,37 @@ void handleInput()
 
 void handleCANInput()
 {
-  // Check if a CAN message has been received
-  if (communication::can0.read(communication::msg))
+  // Read everything received since the last pass and pick it apart by ID; before, the role check and this
+  // function each read one message and dropped the ones meant for the other
+  while (communication::can0.read(communication::msg))
   {
-    // Case 1: Receive paddle position update from Player 1 (Slave sends this)
-    if (communication::msg.id == MotstanderGruppenr + 20) // CAN ID = 21 (Player 1 + 20)
+    const uint32_t id = communication::msg.id;
+    const uint8_t* data = communication::msg.buf;
+    const uint8_t length = communication::msg.len;
+
+    if (id == kmk::pong::masterId || id == kmk::pong::notMasterId)
     {
-      // Update Player 1's paddle position (paddle1Y)
-      game::paddle1Y = communication::msg.buf[0] | (communication::msg.buf[1] << 8);
+      kmk::pong::Role role;
+      if (kmk::can::decode(data, length, role))
+        otherIsMaster = role.master;
     }
-    // Case 2: Receive game state update from Player 1 (Master sends this)
-    else if (communication::msg.id == MotstanderGruppenr + 50) // CAN ID = 51 (Player 1 + 50)
+    // Paddle position from Player 1 (the slave sends this)
+    else if (id == kmk::pong::paddleId(MotstanderGruppenr))
     {
-      // Update ball position
-      game::ballX = communication::msg.buf[0] | (communication::msg.buf[1] << 8);
-      game::ballY = communication::msg.buf[2] | (communication::msg.buf[3] << 8);
-
-      // Update Player 1's paddle position (paddle1Y)
-      game::paddle1Y = communication::msg.buf[4] | (communication::msg.buf[5] << 8);
+      kmk::pong::Paddle paddle;
+      if (kmk::can::decode(data, length, paddle))
+        game::paddle1Y = paddle.y;
+    }
+    // Ball and paddle position from Player 1 (the master sends this)
+    else if (id == kmk::pong::stateId(MotstanderGruppenr))
+    {
+      kmk::pong::GameState state;
+      if (kmk::can::decode(data, length, state))
+      {
+        game::ballX = state.ballX;
+        game::ballY = state.ballY;
+        game::paddle1Y = state.paddleY;
+      }
     }
   }
 }
@@ -230,43 +242,38 @@ void gameMasterControll()
 
 void sendGameState()
 {
-if (!isMaster)
+  if (!isMaster)
   {
-  // Send paddle position if in slave mode
-  communication::msg.id = Gruppenr + 20; // CAN ID for Player 1's paddle position
-  communication::msg.len = 2;
-  communication::msg.buf[0] = game::paddle2Y & 0xFF;          // Lower byte
-  communication::msg.buf[1] = (game::paddle2Y >> 8) & 0xFF;   // Upper byte
-  communication::can0.write(communication::msg);
+    // Send paddle position to Master unit
+    communication::scheduler.queue(communication::tx::Paddle, kmk::pong::paddleId(Gruppenr),
+                                   kmk::pong::Paddle{static_cast<int16_t>(game::paddle2Y)}, micros());
   }
 
-if (isMaster)
+  if (isMaster)
   {
-  communication::msg.id = Gruppenr + 50;
-  communication::msg.len = 6;
-  communication::msg.buf[0] = game::ballX & 0xFF;
-  communication::msg.buf[1] = (game::ballX >> 8) & 0xFF;
-  communication::msg.buf[2] = game::ballY & 0xFF;
-  communication::msg.buf[3] = (game::ballY >> 8) & 0xFF;
-  communication::msg.buf[4] = game::paddle2Y & 0xFF;
-  communication::msg.buf[5] = (game::paddle2Y >> 8) & 0xFF;
-  communication::can0.write(communication::msg);
+    // Send paddle and ball position to Slave unit
+    communication::scheduler.queue(communication::tx::State, kmk::pong::stateId(Gruppenr),
+                                   kmk::pong::GameState{static_cast<int16_t>(game::ballX),
+                                                        static_cast<int16_t>(game::ballY),
+                                                        static_cast<int16_t>(game::paddle2Y)},
+                                   micros());
   }
 }
 
-void drawPaddlesAndBall()
+void sendQueuedFrames()
 {
-  display.clearDisplay();
-
-  // Draw Player 1 paddle on the left side of the screen
-  display.fillRect(0, game::paddle1Y, game::paddleWidth, game::paddleHeight, SSD1306_WHITE);
-
-  // Draw Player 2 paddle on the right side of the screen
-  display.fillRect(carrier::oled::screenWidth - game::paddleWidth, game::paddle2Y,
-                   game::paddleWidth, game::paddleHeight, SSD1306_WHITE);
-
-  // Draw the ball
-  display.fillRect(game::ballX, game::ballY, game::ballSize, game::ballSize, SSD1306_WHITE);
+  // As many as the TX queue takes, most important first; the rest waits for the next loop
+  communication::scheduler.pump(micros(), communication::bus);
+}
 
-  display.display();
+void drawPaddlesAndBall()
+{
+  // Player 1 paddle on the left side of the screen, Player 2 paddle on the right side
+  kmk::pong::draw(display,
+                  {game::paddleWidth, game::paddleHeight, game::ballSize},
+                  {static_cast<int16_t>(game::paddle1Y), static_cast<int16_t>(game::paddle2Y),
+                   static_cast<int16_t>(game::ballX), static_cast<int16_t>(game::ballY)});
+
+  // The frame is still redrawn from scratch, but only the paddle and ball columns that moved go over SPI
+  flusher.flush(display.getBuffer());
 }